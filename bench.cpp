@@ -0,0 +1,202 @@
+#include <cstdio>
+#include <cstdlib>
+#include <chrono>
+#include <vector>
+#include <cstring>
+#include <cmath>
+#include <thread>
+#include "core/random.h"
+#include "core/steering.h"
+#include "core/aabb.h"
+#include "core/simd.h"
+#include "core/simulation.h"
+#include "core/job_system.h"
+#include "core/snapshot.h"
+#include "core/profiler.h"
+
+using namespace std;
+
+// Benchmarks for the simulation: bench [enemies]
+// Prints throughput of each SIMD kernel path against the scalar one, how a
+// crowded Simulation::step scales with the job system's thread count, and
+// where a horde-mode tick spends its frame budget.
+typedef size_t (*OverlapKernel)(const Rect& rect, const float* x, const float* y, const float* w, const float* h,
+                                size_t count, uint64_t* hits);
+
+// Runs pass repeatedly for about 0.2 s; returns elements per millisecond.
+template <typename Pass>
+static double perMs(int count, Pass&& pass) {
+    int passes = 0;
+    double seconds = 0;
+    auto start = chrono::steady_clock::now();
+    while (seconds < 0.2) {
+        pass();
+        passes++;
+        seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+    }
+    return (double)count * passes / (seconds * 1000);
+}
+
+static double enemiesPerMs(SteeringKernel kernel, int count) {
+    Random random(1, 0);
+    vector<float> x(count), y(count), tx(count), ty(count), speed(count), vx(count), vy(count);
+    for (int i = 0; i < count; i++) {
+        x[i] = random.nextFloat() * 800;
+        y[i] = random.nextFloat() * 600;
+        tx[i] = random.nextFloat() * 800;
+        ty[i] = random.nextFloat() * 600;
+        speed[i] = 2 + random.below(3);
+    }
+
+    return perMs(count, [&] { kernel(x.data(), y.data(), tx.data(), ty.data(), speed.data(), 1.0f, vx.data(), vy.data(), count); });
+}
+
+static double rectsPerMs(OverlapKernel kernel, int count) {
+    Random random(2, 0);
+    vector<float> x(count), y(count), w(count, 30), h(count, 30);
+    for (int i = 0; i < count; i++) {
+        x[i] = random.nextFloat() * 800;
+        y[i] = random.nextFloat() * 600;
+    }
+    vector<uint64_t> hits(hitWords(count));
+    Rect player = {380, 280, 40, 40};
+    volatile size_t sink = 0;
+    return perMs(count, [&] { sink = sink + kernel(player, x.data(), y.data(), w.data(), h.data(), count, hits.data()); });
+}
+
+// Prints one row: scalar rate, then each SIMD path the CPU has and its speedup.
+template <typename Rate>
+static void printRow(const char* unit, int count, Rate&& rate) {
+    double scalar = rate(SIMD_SCALAR);
+    printf("  %7d %s: scalar %10.0f", count, unit, scalar);
+    for (SimdPath path : {SIMD_SSE2, SIMD_AVX2}) {
+        if (path > detectSimdPath()) continue;
+        double r = rate(path);
+        printf("  %s %10.0f (%.1fx)", simdPathName(path), r, r / scalar);
+    }
+    printf("\n");
+}
+
+// A Simulation mid-game with `enemies` enemies that cannot die and a bullet
+// pool kept full, stepped `ticks` times. Returns ms per tick; checksum
+// receives a hash of the final enemy positions.
+static double crowdMsPerTick(int threads, int enemyCount, int ticks, uint64_t& checksum) {
+    Simulation sim(HEADLESS_DEFAULT_SEED);
+    JobSystem jobs(threads);
+    sim.setJobSystem(&jobs);
+    sim.apply(CMD_START_GAME);
+    sim.apply(CMD_SELECT_PISTOL);
+    sim.playerDamage = 0;
+
+    Random random(3, 0);
+    sim.enemies.clear();
+    for (int i = 0; i < enemyCount; i++) {
+        sim.enemies.add(random.nextFloat() * (SCREEN_WIDTH - 30), random.nextFloat() * (SCREEN_HEIGHT - 30), 30, 30,
+                        2 + random.below(3), 1000000, BASIC);
+    }
+
+    double tickMs = 1000.0 / DEFAULT_TICK_RATE;
+    double seconds = 0;
+    for (int t = 0; t < ticks; t++) {
+        while (Bullet* b = sim.bullets.spawn()) {
+            float angle = random.nextFloat() * 6.2831853f;
+            b->rect = {random.nextFloat() * SCREEN_WIDTH, random.nextFloat() * SCREEN_HEIGHT, 10, 10};
+            b->prev = {b->rect.x, b->rect.y};
+            b->dx = cosf(angle);
+            b->dy = sinf(angle);
+            b->speed = 8;
+            b->type = Bullet::PISTOL;
+        }
+        sim.playerHealth = 1000000;
+
+        auto start = chrono::steady_clock::now();
+        SimInput input;
+        input.right = (t / 60) % 2 == 0;
+        input.left = !input.right;
+        sim.step(input, tickMs);
+        seconds += chrono::duration<double>(chrono::steady_clock::now() - start).count();
+    }
+
+    checksum = 1469598103934665603ULL;
+    for (size_t i = 0; i < sim.enemies.size(); i++) {
+        uint32_t bits[2];
+        memcpy(&bits[0], &sim.enemies.x[i], 4);
+        memcpy(&bits[1], &sim.enemies.y[i], 4);
+        checksum = (checksum ^ bits[0]) * 1099511628211ULL;
+        checksum = (checksum ^ bits[1]) * 1099511628211ULL;
+    }
+    return seconds * 1000 / ticks;
+}
+
+// Horde mode at its target load, stepped the way the game steps it: each
+// tick followed by the snapshot copy the renderer reads. Prints per-zone cost
+// over the profiler's history against the frame budget at the default tick rate.
+// slices > 1 refreshes that fraction of the enemy headings per tick.
+static void hordeBreakdown(int threads, int slices) {
+    const int warmupTicks = 120;
+    Simulation sim(HEADLESS_DEFAULT_SEED);
+    JobSystem jobs(threads);
+    sim.setJobSystem(&jobs);
+    sim.setSteeringSlices(slices);
+    sim.apply(CMD_START_HORDE);
+    sim.apply(CMD_SELECT_PISTOL);
+
+    Snapshot snapshot;
+    double tickMs = 1000.0 / DEFAULT_TICK_RATE;
+    for (int t = 0; t < warmupTicks + Profiler::HISTORY_FRAMES; t++) {
+        SimInput input;
+        input.right = (t / 60) % 2 == 0;
+        input.left = !input.right;
+        sim.step(input, tickMs);
+        captureSnapshot(sim, snapshot);
+        profiler().endFrame();
+    }
+
+    printf("Horde tick, %d threads, steering 1/%d per tick: %zu enemies, %d bullets, %zu sprites; ms avg / p99\n", threads,
+           slices, sim.enemies.size(), sim.bullets.size(), snapshot.sprites.size());
+    double total = 0;
+    for (const ProfileZoneStats& zone : profiler().stats()) {
+        printf("  %-10s %7.3f / %7.3f\n", zone.name, zone.avgMs, zone.p99Ms);
+        if (strcmp(zone.name, "step") == 0 || strcmp(zone.name, "snapshot") == 0) total += zone.avgMs;
+    }
+    printf("  step + snapshot %.3f ms of a %.3f ms tick%s\n", total, tickMs, total > tickMs ? "  OVER BUDGET" : "");
+}
+
+int main(int argc, char* argv[]) {
+    vector<int> counts = {1000, 10000, 100000};
+    if (argc > 1 && atoi(argv[1]) > 0) counts = {atoi(argv[1])};
+
+    printf("Detected SIMD path: %s\n", simdPathName(detectSimdPath()));
+    printf("Steering, enemies/ms\n");
+    for (int count : counts) {
+        printRow("enemies", count, [&](SimdPath path) {
+            return enemiesPerMs(path == SIMD_AVX2 ? steerAVX2 : path == SIMD_SSE2 ? steerSSE2 : steerScalar, count);
+        });
+    }
+    printf("Player AABB batch, rects/ms\n");
+    for (int count : counts) {
+        printRow("rects", count, [&](SimdPath path) {
+            return rectsPerMs(path == SIMD_AVX2 ? overlapMaskAVX2 : path == SIMD_SSE2 ? overlapMaskSSE2 : overlapMaskScalar, count);
+        });
+    }
+
+    int crowd = argc > 1 && atoi(argv[1]) > 0 ? atoi(argv[1]) : 20000;
+    printf("Crowd step, %d enemies, %d bullets (%u hardware threads)\n", crowd, MAX_BULLETS, thread::hardware_concurrency());
+    double single = 0;
+    uint64_t reference = 0;
+    for (int threads : {1, 2, 4, 8}) {
+        uint64_t checksum;
+        double ms = crowdMsPerTick(threads, crowd, 120, checksum);
+        if (threads == 1) {
+            single = ms;
+            reference = checksum;
+        }
+        printf("  %d threads: %7.3f ms/tick (%.2fx)%s\n", threads, ms, single / ms,
+               checksum == reference ? "" : "  RESULT DIFFERS FROM 1 THREAD");
+    }
+
+    hordeBreakdown(1, 1);
+    hordeBreakdown(1, 4);
+    if (thread::hardware_concurrency() > 1) hordeBreakdown((int)thread::hardware_concurrency(), 1);
+    return 0;
+}
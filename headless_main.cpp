@@ -0,0 +1,31 @@
+#include <cstdlib>
+#include <string>
+#include "constant.h"
+#include "core/headless.h"
+
+// SDL-free entry point for the simulation core:
+//   headless [--horde] [ticks] [tick rate] [seed] [threads]
+//   headless --replay file
+int main(int argc, char* argv[]) {
+    if (argc > 2 && string(argv[1]) == "--replay") return runReplay(argv[2]) ? 0 : 1;
+
+    GameMode mode = MODE_WAVES;
+    if (argc > 1 && string(argv[1]) == "--horde") {
+        mode = MODE_HORDE;
+        argv++;
+        argc--;
+    }
+
+    int ticks = HEADLESS_DEFAULT_TICKS;
+    int tickRate = DEFAULT_TICK_RATE;
+    if (argc > 1 && atoi(argv[1]) > 0) ticks = atoi(argv[1]);
+    if (argc > 2 && atoi(argv[2]) > 0) tickRate = atoi(argv[2]);
+    unsigned long long seed = argc > 3 ? strtoull(argv[3], nullptr, 10) : HEADLESS_DEFAULT_SEED;
+    int threads = argc > 4 && atoi(argv[4]) > 0 ? atoi(argv[4]) : 1;
+
+    Simulation sim(seed);
+    JobSystem jobs(threads);
+    sim.setJobSystem(&jobs);
+    runHeadless(sim, ticks, tickRate, mode);
+    return 0;
+}
@@ -12,11 +12,65 @@
 #include <fstream>
 #include "game.h"
 #include "constant.h"
+#include "core/headless.h"
 
 using namespace std;
 
 int main(int argc, char* argv[]) {
-    Game game;
+    GameConfig config;
+    int headlessTicks = 0;
+    bool seeded = false;
+    string replayPath;
+    GameMode headlessMode = MODE_WAVES;
+
+    // --headless [ticks]: simulate without a window or audio device and report throughput.
+    // --horde: with --headless, play horde mode instead of waves.
+    // --tick-rate N: simulation ticks per second. --no-vsync: render uncapped.
+    // --seed N: seed for every random stream; runs with equal seeds and input are identical.
+    // --record file: log every tick's input and menu command; --replay file: re-run such a log headlessly.
+    // --threads N: simulation job threads (default: one per hardware thread).
+    // --trace [file]: record a Chrome trace from startup, written at exit (default trace.json).
+    for (int i = 1; i < argc; i++) {
+        string arg = argv[i];
+        if (arg == "--headless") {
+            headlessTicks = HEADLESS_DEFAULT_TICKS;
+            if (i + 1 < argc && atoi(argv[i + 1]) > 0) headlessTicks = atoi(argv[++i]);
+        } else if (arg == "--horde") {
+            headlessMode = MODE_HORDE;
+        } else if (arg == "--tick-rate" && i + 1 < argc) {
+            config.tickRate = max(1, atoi(argv[++i]));
+        } else if (arg == "--no-vsync") {
+            config.vsync = false;
+        } else if (arg == "--seed" && i + 1 < argc) {
+            config.seed = strtoull(argv[++i], nullptr, 10);
+            seeded = true;
+        } else if (arg == "--record" && i + 1 < argc) {
+            config.recordPath = argv[++i];
+        } else if (arg == "--replay" && i + 1 < argc) {
+            replayPath = argv[++i];
+        } else if (arg == "--threads" && i + 1 < argc) {
+            config.threads = max(1, atoi(argv[++i]));
+        } else if (arg == "--trace") {
+            config.tracePath = "trace.json";
+            if (i + 1 < argc && argv[i + 1][0] != '-') config.tracePath = argv[++i];
+        }
+    }
+
+    if (!replayPath.empty()) return runReplay(replayPath) ? 0 : 1;
+
+    // Headless runs are benchmarks, so they default to a fixed seed.
+    if (!seeded) config.seed = headlessTicks > 0 ? HEADLESS_DEFAULT_SEED : (uint64_t)time(nullptr);
+    cout << "Seed: " << config.seed << endl;
+
+    if (headlessTicks > 0) {
+        Simulation sim(config.seed);
+        JobSystem jobs(jobThreads(config.threads));
+        sim.setJobSystem(&jobs);
+        runHeadless(sim, headlessTicks, config.tickRate, headlessMode);
+        return 0;
+    }
+
+    Game game(config);
     if (game.init()) {
         game.run();
     }
@@ -0,0 +1,157 @@
+#include "core/aabb.h"
+#include "core/simd.h"
+
+#include <algorithm>
+
+#if defined(__SSE2__)
+#define AABB_X86 1
+#include <immintrin.h>
+#endif
+
+using namespace std;
+
+static inline bool overlaps(const Rect& a, float x, float y, float w, float h) {
+    return w > 0 && h > 0 && a.x < x + w && x < a.x + a.w && a.y < y + h && y < a.y + a.h;
+}
+
+// Tests [begin, count) and ORs the results into already cleared words.
+static size_t scalarRange(const Rect& rect, const float* x, const float* y, const float* w, const float* h,
+                          size_t begin, size_t count, uint64_t* hits) {
+    size_t found = 0;
+    for (size_t i = begin; i < count; i++) {
+        if (overlaps(rect, x[i], y[i], w[i], h[i])) {
+            hits[i / 64] |= 1ULL << (i % 64);
+            found++;
+        }
+    }
+    return found;
+}
+
+static bool emptyRect(const Rect& rect) {
+    return rect.w <= 0 || rect.h <= 0;
+}
+
+size_t overlapMaskScalar(const Rect& rect, const float* x, const float* y, const float* w, const float* h, size_t count, uint64_t* hits) {
+    fill(hits, hits + hitWords(count), 0);
+    if (emptyRect(rect)) return 0;
+    return scalarRange(rect, x, y, w, h, 0, count, hits);
+}
+
+#ifdef AABB_X86
+// Four rects as lanes: the overlap condition for each, as a 4-bit mask.
+static inline int overlapLanes(__m128 ax0, __m128 ax1, __m128 ay0, __m128 ay1, __m128 x, __m128 y, __m128 w, __m128 h) {
+    const __m128 zero = _mm_setzero_ps();
+    __m128 hit = _mm_and_ps(_mm_cmpgt_ps(w, zero), _mm_cmpgt_ps(h, zero));
+    hit = _mm_and_ps(hit, _mm_cmplt_ps(ax0, _mm_add_ps(x, w)));
+    hit = _mm_and_ps(hit, _mm_cmplt_ps(x, ax1));
+    hit = _mm_and_ps(hit, _mm_cmplt_ps(ay0, _mm_add_ps(y, h)));
+    hit = _mm_and_ps(hit, _mm_cmplt_ps(y, ay1));
+    return _mm_movemask_ps(hit);
+}
+
+size_t overlapMaskSSE2(const Rect& rect, const float* x, const float* y, const float* w, const float* h, size_t count, uint64_t* hits) {
+    fill(hits, hits + hitWords(count), 0);
+    if (emptyRect(rect)) return 0;
+    __m128 ax0 = _mm_set1_ps(rect.x), ax1 = _mm_set1_ps(rect.x + rect.w);
+    __m128 ay0 = _mm_set1_ps(rect.y), ay1 = _mm_set1_ps(rect.y + rect.h);
+    size_t found = 0;
+    size_t i = 0;
+    for (; i + 4 <= count; i += 4) {
+        int mask = overlapLanes(ax0, ax1, ay0, ay1, _mm_loadu_ps(x + i), _mm_loadu_ps(y + i), _mm_loadu_ps(w + i), _mm_loadu_ps(h + i));
+        if (mask) {
+            hits[i / 64] |= (uint64_t)mask << (i % 64);
+            found += __builtin_popcount(mask);
+        }
+    }
+    return found + scalarRange(rect, x, y, w, h, i, count, hits);
+}
+
+__attribute__((target("avx2")))
+size_t overlapMaskAVX2(const Rect& rect, const float* x, const float* y, const float* w, const float* h, size_t count, uint64_t* hits) {
+    fill(hits, hits + hitWords(count), 0);
+    if (emptyRect(rect)) return 0;
+    const __m256 zero = _mm256_setzero_ps();
+    __m256 ax0 = _mm256_set1_ps(rect.x), ax1 = _mm256_set1_ps(rect.x + rect.w);
+    __m256 ay0 = _mm256_set1_ps(rect.y), ay1 = _mm256_set1_ps(rect.y + rect.h);
+    size_t found = 0;
+    size_t i = 0;
+    for (; i + 8 <= count; i += 8) {
+        __m256 bx = _mm256_loadu_ps(x + i), by = _mm256_loadu_ps(y + i);
+        __m256 bw = _mm256_loadu_ps(w + i), bh = _mm256_loadu_ps(h + i);
+        __m256 hit = _mm256_and_ps(_mm256_cmp_ps(bw, zero, _CMP_GT_OQ), _mm256_cmp_ps(bh, zero, _CMP_GT_OQ));
+        hit = _mm256_and_ps(hit, _mm256_cmp_ps(ax0, _mm256_add_ps(bx, bw), _CMP_LT_OQ));
+        hit = _mm256_and_ps(hit, _mm256_cmp_ps(bx, ax1, _CMP_LT_OQ));
+        hit = _mm256_and_ps(hit, _mm256_cmp_ps(ay0, _mm256_add_ps(by, bh), _CMP_LT_OQ));
+        hit = _mm256_and_ps(hit, _mm256_cmp_ps(by, ay1, _CMP_LT_OQ));
+        int mask = _mm256_movemask_ps(hit);
+        if (mask) {
+            hits[i / 64] |= (uint64_t)mask << (i % 64);
+            found += __builtin_popcount(mask);
+        }
+    }
+    return found + scalarRange(rect, x, y, w, h, i, count, hits);
+}
+
+size_t overlapMaskStrided(const Rect& rect, const Rect* first, size_t stride, size_t count, uint64_t* hits) {
+    fill(hits, hits + hitWords(count), 0);
+    if (emptyRect(rect)) return 0;
+    const char* base = reinterpret_cast<const char*>(first);
+    size_t found = 0;
+    size_t i = 0;
+    if (simdPath() != SIMD_SCALAR) {
+        __m128 ax0 = _mm_set1_ps(rect.x), ax1 = _mm_set1_ps(rect.x + rect.w);
+        __m128 ay0 = _mm_set1_ps(rect.y), ay1 = _mm_set1_ps(rect.y + rect.h);
+        for (; i + 4 <= count; i += 4) {
+            // Each load is one {x, y, w, h}; transposing gives four lanes per field.
+            __m128 x = _mm_loadu_ps(reinterpret_cast<const float*>(base + i * stride));
+            __m128 y = _mm_loadu_ps(reinterpret_cast<const float*>(base + (i + 1) * stride));
+            __m128 w = _mm_loadu_ps(reinterpret_cast<const float*>(base + (i + 2) * stride));
+            __m128 h = _mm_loadu_ps(reinterpret_cast<const float*>(base + (i + 3) * stride));
+            _MM_TRANSPOSE4_PS(x, y, w, h);
+            int mask = overlapLanes(ax0, ax1, ay0, ay1, x, y, w, h);
+            if (mask) {
+                hits[i / 64] |= (uint64_t)mask << (i % 64);
+                found += __builtin_popcount(mask);
+            }
+        }
+    }
+    for (; i < count; i++) {
+        const Rect& r = *reinterpret_cast<const Rect*>(base + i * stride);
+        if (overlaps(rect, r.x, r.y, r.w, r.h)) {
+            hits[i / 64] |= 1ULL << (i % 64);
+            found++;
+        }
+    }
+    return found;
+}
+#else
+size_t overlapMaskSSE2(const Rect& rect, const float* x, const float* y, const float* w, const float* h, size_t count, uint64_t* hits) {
+    return overlapMaskScalar(rect, x, y, w, h, count, hits);
+}
+
+size_t overlapMaskAVX2(const Rect& rect, const float* x, const float* y, const float* w, const float* h, size_t count, uint64_t* hits) {
+    return overlapMaskScalar(rect, x, y, w, h, count, hits);
+}
+
+size_t overlapMaskStrided(const Rect& rect, const Rect* first, size_t stride, size_t count, uint64_t* hits) {
+    fill(hits, hits + hitWords(count), 0);
+    if (emptyRect(rect)) return 0;
+    const char* base = reinterpret_cast<const char*>(first);
+    size_t found = 0;
+    for (size_t i = 0; i < count; i++) {
+        const Rect& r = *reinterpret_cast<const Rect*>(base + i * stride);
+        if (overlaps(rect, r.x, r.y, r.w, r.h)) {
+            hits[i / 64] |= 1ULL << (i % 64);
+            found++;
+        }
+    }
+    return found;
+}
+#endif
+
+size_t overlapMask(const Rect& rect, const float* x, const float* y, const float* w, const float* h, size_t count, uint64_t* hits) {
+    SimdPath path = simdPath();
+    if (path == SIMD_AVX2) return overlapMaskAVX2(rect, x, y, w, h, count, hits);
+    if (path == SIMD_SSE2) return overlapMaskSSE2(rect, x, y, w, h, count, hits);
+    return overlapMaskScalar(rect, x, y, w, h, count, hits);
+}
@@ -0,0 +1,129 @@
+#include "core/headless.h"
+#include "core/profiler.h"
+#include "core/replay.h"
+
+#include <chrono>
+#include <iostream>
+#include <algorithm>
+
+using namespace std;
+
+// Headless bot: circles the arena, fires at the nearest enemy, alternates
+// weapons between runs and spends coins whenever a menu comes up.
+static SimInput scriptInput(Simulation& sim, int tick, GameMode mode) {
+    SimInput input;
+    int phase = (tick / 90) % 4;
+    input.up = phase == 0;
+    input.right = phase == 1;
+    input.down = phase == 2;
+    input.left = phase == 3;
+
+    const EnemyStore& enemies = sim.enemies;
+    int best = -1;
+    float bestDist = 0;
+    for (size_t i = 0; i < enemies.size(); i++) {
+        float dx = enemies.x[i] - sim.player.rect.x;
+        float dy = enemies.y[i] - sim.player.rect.y;
+        float d = dx * dx + dy * dy;
+        if (best == -1 || d < bestDist) {
+            best = (int)i;
+            bestDist = d;
+        }
+    }
+    input.fire = best != -1;
+    if (best != -1) {
+        input.aimX = enemies.x[best] + enemies.w[best] / 2;
+        input.aimY = enemies.y[best] + enemies.h[best] / 2;
+    }
+
+    if (sim.gameState == TITLE_SCREEN) {
+        if (mode == MODE_HORDE) sim.startHorde();
+        else sim.startGame();
+    } else if (sim.gameState == WEAPON_SELECTION) {
+        sim.selectWeapon(sim.selectedWeapon == PISTOL ? SHOTGUN : PISTOL);
+    } else if (sim.gameState == SHOP) {
+        if (sim.coins >= 25) sim.buyDamage();
+        else sim.leaveShop();
+    } else if (sim.gameState == UPGRADE_MENU) {
+        sim.chooseUpgrade(2);
+    }
+    return input;
+}
+
+static void printThroughput(int ticks, double seconds) {
+    cout << ticks << " ticks in " << seconds << " s (" << (seconds > 0 ? ticks / seconds : 0) << " ticks/s)" << endl;
+}
+
+static void printProfile() {
+    cout << "  last " << Profiler::HISTORY_FRAMES << " ticks, us min / avg / p99:" << endl;
+    for (const ProfileZoneStats& zone : profiler().stats()) {
+        cout << "    " << zone.name << ": " << zone.minMs * 1000 << " / " << zone.avgMs * 1000 << " / " << zone.p99Ms * 1000 << endl;
+    }
+}
+
+void runHeadless(Simulation& sim, int ticks, int tickRate, GameMode mode) {
+    double tickMs = 1000.0 / tickRate;
+    int deaths = 0, maxWave = 1;
+    size_t peakEnemies = 0;
+    int peakBullets = 0;
+
+    auto start = chrono::steady_clock::now();
+    int tick = 0;
+    for (; tick < ticks; tick++) {
+        SimInput input = scriptInput(sim, tick, mode);
+        if (sim.gameState == GAME_OVER) {
+            deaths++;
+            sim.returnToTitle();
+            continue;
+        }
+        sim.step(input, tickMs);
+        profiler().endFrame();
+
+        maxWave = max(maxWave, sim.wave - 1);
+        peakEnemies = max(peakEnemies, sim.enemies.size());
+        peakBullets = max(peakBullets, sim.bullets.size());
+    }
+    double seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+
+    cout << (mode == MODE_HORDE ? "Headless horde run: " : "Headless run: ");
+    printThroughput(tick, seconds);
+    cout << "  seed " << sim.seed() << ", wave " << sim.wave - 1 << " (max " << maxWave << "), deaths " << deaths << ", score " << sim.score << endl;
+    cout << "  enemies " << sim.enemies.size() << " (peak " << peakEnemies << "), bullets " << sim.bullets.size()
+         << " (peak " << peakBullets << "), coins " << sim.coinsOnGround.size() << ", power-ups " << sim.powerUps.size() << endl;
+    printProfile();
+}
+
+bool runReplay(const string& path) {
+    ReplayReader reader;
+    if (!reader.open(path)) {
+        cout << "Cannot read replay " << path << endl;
+        return false;
+    }
+    Simulation sim(reader.seed);
+    double tickMs = 1000.0 / reader.tickRate;
+    int ticks = 0, commands = 0, deaths = 0;
+
+    auto start = chrono::steady_clock::now();
+    ReplayEntry entry;
+    while (reader.next(entry)) {
+        if (entry.kind == ReplayEntry::COMMAND) {
+            sim.apply(entry.command);
+            commands++;
+            continue;
+        }
+        sim.step(entry.input, tickMs);
+        profiler().endFrame();
+        if (sim.events.playerDied) deaths++;
+        ticks++;
+    }
+    double seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+
+    cout << "Replay " << path << ": ";
+    printThroughput(ticks, seconds);
+    cout << "  seed " << reader.seed << ", tick rate " << reader.tickRate << ", " << commands << " menu commands" << endl;
+    cout << "  wave " << sim.wave - 1 << ", deaths " << deaths << ", score " << sim.score << ", health " << sim.playerHealth
+         << ", coins " << sim.coins << endl;
+    cout << "  enemies " << sim.enemies.size() << ", bullets " << sim.bullets.size() << endl;
+    printProfile();
+    return true;
+}
@@ -0,0 +1,82 @@
+#include "core/job_system.h"
+
+#include <algorithm>
+
+JobSystem::JobSystem(int threads) {
+    threads = max(1, threads);
+    for (int i = 0; i < threads; i++) queues.push_back(make_unique<Queue>());
+    for (int i = 1; i < threads; i++) workers.emplace_back([this, i] { workerLoop(i); });
+}
+
+JobSystem::~JobSystem() {
+    {
+        lock_guard<mutex> lock(sleepLock);
+        stopping = true;
+    }
+    wake.notify_all();
+    for (thread& worker : workers) worker.join();
+}
+
+void JobSystem::run(size_t count, size_t grain, RangeFunction function, void* context) {
+    // A few chunks per thread leaves something to steal when they run unevenly.
+    size_t chunks = min((count + grain - 1) / grain, (size_t)threadCount() * 4);
+    size_t chunkSize = (count + chunks - 1) / chunks;
+    chunks = (count + chunkSize - 1) / chunkSize;
+
+    pending += (int)chunks;
+    for (size_t c = 0; c < chunks; c++) {
+        Queue& queue = *queues[c % queues.size()];
+        lock_guard<mutex> lock(queue.lock);
+        queue.jobs.push_back({function, context, c * chunkSize, min(count, (c + 1) * chunkSize)});
+    }
+    {
+        lock_guard<mutex> lock(sleepLock);
+    }
+    wake.notify_all();
+
+    while (pending > 0) {
+        if (!runOne(0)) this_thread::yield();
+    }
+}
+
+bool JobSystem::runOne(int self) {
+    Job job;
+    bool found = false;
+    {
+        Queue& own = *queues[self];
+        lock_guard<mutex> lock(own.lock);
+        if (!own.jobs.empty()) {
+            job = own.jobs.back();
+            own.jobs.pop_back();
+            found = true;
+        }
+    }
+    for (int i = 1; !found && i < threadCount(); i++) {
+        Queue& victim = *queues[(self + i) % threadCount()];
+        lock_guard<mutex> lock(victim.lock);
+        if (!victim.jobs.empty()) {
+            job = victim.jobs.front();
+            victim.jobs.pop_front();
+            found = true;
+        }
+    }
+    if (!found) return false;
+
+    job.function(job.context, job.begin, job.end);
+    pending--;
+    return true;
+}
+
+void JobSystem::workerLoop(int self) {
+    while (true) {
+        if (runOne(self)) continue;
+        unique_lock<mutex> lock(sleepLock);
+        wake.wait(lock, [this] { return stopping || pending > 0; });
+        if (stopping) return;
+        lock.unlock();
+        // Jobs may all be taken already; spin on them while the batch is live.
+        while (pending > 0 && !stopping) {
+            if (!runOne(self)) this_thread::yield();
+        }
+    }
+}
@@ -0,0 +1,140 @@
+#include "core/profiler.h"
+
+#include <chrono>
+#include <cstring>
+#include <algorithm>
+#include <fstream>
+#include <iostream>
+#include <atomic>
+
+static uint64_t steadyClockNow() {
+    return (uint64_t)chrono::steady_clock::now().time_since_epoch().count();
+}
+
+Profiler::Profiler()
+    : clock(steadyClockNow),
+      ticksPerSecond((uint64_t)(chrono::steady_clock::period::den / chrono::steady_clock::period::num)) {}
+
+Profiler::~Profiler() {
+    finishTraceWrites();
+}
+
+Profiler& profiler() {
+    static Profiler instance;
+    return instance;
+}
+
+void Profiler::setClock(ClockFunction now, uint64_t frequency) {
+    clock = now;
+    ticksPerSecond = frequency;
+}
+
+int Profiler::threadId() {
+    static atomic<int> nextId{0};
+    thread_local int id = nextId++;
+    return id;
+}
+
+int Profiler::zone(const char* name) {
+    lock_guard<mutex> hold(lock);
+    for (size_t i = 0; i < zones.size(); i++) {
+        if (strcmp(zones[i].name, name) == 0) return (int)i;
+    }
+    Zone z;
+    z.name = name;
+    z.history.assign(HISTORY_FRAMES, 0);
+    zones.push_back(z);
+    return (int)zones.size() - 1;
+}
+
+void Profiler::endFrame() {
+    lock_guard<mutex> hold(lock);
+    for (Zone& z : zones) {
+        z.lastCalls = z.frameCalls;
+        if (z.frameCalls == 0) continue;
+        z.history[z.head] = z.frameTicks;
+        z.head = (z.head + 1) % HISTORY_FRAMES;
+        z.count = min(z.count + 1, HISTORY_FRAMES);
+        z.frameTicks = 0;
+        z.frameCalls = 0;
+    }
+}
+
+vector<ProfileZoneStats> Profiler::stats() const {
+    lock_guard<mutex> hold(lock);
+    vector<ProfileZoneStats> result;
+    vector<uint64_t> samples;
+    double msPerTick = 1000.0 / ticksPerSecond;
+    for (const Zone& z : zones) {
+        if (z.count == 0) continue;
+        samples.assign(z.history.begin(), z.history.begin() + z.count);
+        uint64_t total = 0;
+        for (uint64_t s : samples) total += s;
+        size_t p99 = min(samples.size() - 1, samples.size() * 99 / 100);
+        nth_element(samples.begin(), samples.begin() + p99, samples.end());
+        uint64_t lowest = *min_element(samples.begin(), samples.end());
+
+        ProfileZoneStats s;
+        s.name = z.name;
+        s.minMs = lowest * msPerTick;
+        s.avgMs = (double)total / z.count * msPerTick;
+        s.p99Ms = samples[p99] * msPerTick;
+        s.calls = z.lastCalls;
+        result.push_back(s);
+    }
+    return result;
+}
+
+void Profiler::startTrace(size_t capacity) {
+    finishTraceWrites();
+    lock_guard<mutex> hold(lock);
+    trace.clear();
+    trace.reserve(capacity);
+    spareTrace.clear();
+    spareTrace.reserve(capacity);
+    droppedEvents = 0;
+    traceStart = clock();
+    tracing = true;
+}
+
+void Profiler::writeTrace(const string& path) {
+    if (!isTracing()) return;
+    finishTraceWrites();
+    lock_guard<mutex> hold(lock);
+
+    // The writer takes the filled buffer; capture carries on in the spare one.
+    vector<TraceEvent> events;
+    events.swap(trace);
+    trace.swap(spareTrace);
+    trace.clear();
+    size_t dropped = droppedEvents;
+    droppedEvents = 0;
+    uint64_t origin = traceStart;
+    double usPerTick = 1000000.0 / ticksPerSecond;
+
+    traceWriter = thread([this, path, events = move(events), dropped, origin, usPerTick]() mutable {
+        ofstream file(path);
+        if (!file) {
+            cout << "Failed to open " << path << endl;
+        } else {
+            file << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+            for (size_t i = 0; i < events.size(); i++) {
+                const TraceEvent& e = events[i];
+                double ts = (double)(e.start - origin) * usPerTick;
+                file << (i ? ",\n" : "\n") << "{\"name\":\"" << e.name << "\",\"ph\":\"X\",\"pid\":0,\"tid\":" << e.thread << ",\"ts\":"
+                     << fixed << ts << ",\"dur\":" << e.duration * usPerTick << "}";
+            }
+            file << "\n]}\n";
+            cout << "Wrote " << events.size() << " trace events to " << path;
+            if (dropped) cout << " (" << dropped << " dropped, buffer full)";
+            cout << endl;
+        }
+        // Hand the buffer back so the next swap does not allocate.
+        events.clear();
+        spareTrace = move(events);
+    });
+}
+
+void Profiler::finishTraceWrites() {
+    if (traceWriter.joinable()) traceWriter.join();
+}
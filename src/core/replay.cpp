@@ -0,0 +1,109 @@
+#include "core/replay.h"
+
+#include <algorithm>
+
+static const char REPLAY_MAGIC[4] = {'D', 'S', 'R', 'P'};
+static const uint32_t REPLAY_VERSION = 1;
+
+static const uint8_t TICK_BIT = 0x80;
+static const uint8_t UP_BIT = 1 << 0;
+static const uint8_t DOWN_BIT = 1 << 1;
+static const uint8_t LEFT_BIT = 1 << 2;
+static const uint8_t RIGHT_BIT = 1 << 3;
+static const uint8_t FIRE_BIT = 1 << 4;
+static const uint8_t AIM_BIT = 1 << 5;
+
+template <typename T>
+static void writeValue(ofstream& file, T value) {
+    file.write(reinterpret_cast<const char*>(&value), sizeof(value));
+}
+
+template <typename T>
+static bool readValue(ifstream& file, T& value) {
+    return (bool)file.read(reinterpret_cast<char*>(&value), sizeof(value));
+}
+
+static int16_t toAim(float value) {
+    return (int16_t)max(-32768.0f, min(32767.0f, value));
+}
+
+bool ReplayWriter::open(const string& path, uint64_t seed, int tickRate) {
+    file.open(path, ios::binary | ios::trunc);
+    if (!file) return false;
+    file.write(REPLAY_MAGIC, sizeof(REPLAY_MAGIC));
+    writeValue(file, REPLAY_VERSION);
+    writeValue(file, seed);
+    writeValue(file, (uint32_t)tickRate);
+    aimX = aimY = 0;
+    ticks = 0;
+    return true;
+}
+
+void ReplayWriter::command(SimCommand command) {
+    if (file.is_open()) file.put((char)command);
+}
+
+void ReplayWriter::tick(const SimInput& input) {
+    if (!file.is_open()) return;
+    int16_t x = toAim(input.aimX), y = toAim(input.aimY);
+    bool aimMoved = ticks == 0 || x != aimX || y != aimY;
+
+    uint8_t tag = TICK_BIT;
+    if (input.up) tag |= UP_BIT;
+    if (input.down) tag |= DOWN_BIT;
+    if (input.left) tag |= LEFT_BIT;
+    if (input.right) tag |= RIGHT_BIT;
+    if (input.fire) tag |= FIRE_BIT;
+    if (aimMoved) tag |= AIM_BIT;
+    file.put((char)tag);
+    if (aimMoved) {
+        writeValue(file, x);
+        writeValue(file, y);
+        aimX = x;
+        aimY = y;
+    }
+    ticks++;
+}
+
+void ReplayWriter::close() {
+    if (file.is_open()) file.close();
+}
+
+bool ReplayReader::open(const string& path) {
+    file.open(path, ios::binary);
+    char magic[4];
+    uint32_t version, rate;
+    if (!file.read(magic, sizeof(magic)) || !equal(magic, magic + 4, REPLAY_MAGIC)) return false;
+    if (!readValue(file, version) || version != REPLAY_VERSION) return false;
+    if (!readValue(file, seed) || !readValue(file, rate) || rate == 0) return false;
+    tickRate = (int)rate;
+    last = SimInput();
+    return true;
+}
+
+bool ReplayReader::next(ReplayEntry& entry) {
+    int tag = file.get();
+    if (tag == EOF) return false;
+    if (!(tag & TICK_BIT)) {
+        if (tag >= SIM_COMMAND_COUNT) return false;
+        entry.kind = ReplayEntry::COMMAND;
+        entry.command = (SimCommand)tag;
+        return true;
+    }
+
+    SimInput& input = last;
+    input.up = tag & UP_BIT;
+    input.down = tag & DOWN_BIT;
+    input.left = tag & LEFT_BIT;
+    input.right = tag & RIGHT_BIT;
+    input.fire = tag & FIRE_BIT;
+    if (tag & AIM_BIT) {
+        int16_t x, y;
+        if (!readValue(file, x) || !readValue(file, y)) return false;
+        input.aimX = x;
+        input.aimY = y;
+    }
+    entry.kind = ReplayEntry::TICK;
+    entry.input = input;
+    return true;
+}
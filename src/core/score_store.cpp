@@ -0,0 +1,111 @@
+#include "core/score_store.h"
+
+#include <fstream>
+#include <algorithm>
+#include <filesystem>
+#include <iostream>
+
+static const char RUN_LOG_MAGIC[4] = {'R', 'U', 'N', '1'};
+
+ScoreStore::ScoreStore(const string& highScorePath, const string& runLogPath)
+    : highScorePath(highScorePath), runLogPath(runLogPath), best(0), stopping(false) {
+    writer = thread([this] { writeLoop(); });
+}
+
+ScoreStore::~ScoreStore() {
+    close();
+}
+
+void ScoreStore::load() {
+    ifstream scoreFile(highScorePath);
+    if (scoreFile.is_open()) scoreFile >> best;
+
+    top.clear();
+    ifstream log(runLogPath, ios::binary);
+    char magic[4];
+    if (!log.read(magic, sizeof(magic)) || !equal(magic, magic + 4, RUN_LOG_MAGIC)) return;
+    RunRecord run;
+    while (log.read(reinterpret_cast<char*>(&run), sizeof(run))) {
+        addToTop(run);
+        best = max(best, (int)run.score);
+    }
+}
+
+vector<RunRecord> ScoreStore::topRuns(int n) const {
+    n = max(0, min(n, (int)top.size()));
+    return vector<RunRecord>(top.begin(), top.begin() + n);
+}
+
+void ScoreStore::recordRun(const RunRecord& run) {
+    bool newHighScore = run.score > best;
+    if (newHighScore) best = run.score;
+    addToTop(run);
+
+    lock_guard<mutex> lock(queueMutex);
+    queue.push_back({run, newHighScore});
+    queueChanged.notify_one();
+}
+
+void ScoreStore::close() {
+    {
+        lock_guard<mutex> lock(queueMutex);
+        stopping = true;
+        queueChanged.notify_one();
+    }
+    if (writer.joinable()) writer.join();
+}
+
+void ScoreStore::addToTop(const RunRecord& run) {
+    auto pos = upper_bound(top.begin(), top.end(), run, [](const RunRecord& a, const RunRecord& b) {
+        return a.score > b.score;
+    });
+    if (pos - top.begin() >= TOP_RUNS_KEPT) return;
+    top.insert(pos, run);
+    if ((int)top.size() > TOP_RUNS_KEPT) top.pop_back();
+}
+
+void ScoreStore::writeLoop() {
+    unique_lock<mutex> lock(queueMutex);
+    while (true) {
+        queueChanged.wait(lock, [this] { return stopping || !queue.empty(); });
+        if (queue.empty()) return;
+        WriteJob job = queue.front();
+        queue.pop_front();
+
+        lock.unlock();
+        appendRun(job.run);
+        if (job.newHighScore) replaceHighScore(job.run.score);
+        lock.lock();
+    }
+}
+
+void ScoreStore::appendRun(const RunRecord& run) {
+    // Runs on the writer thread, so filesystem errors are reported, not thrown.
+    error_code error;
+    bool exists = filesystem::exists(runLogPath, error);
+    uintmax_t size = (exists && !error) ? filesystem::file_size(runLogPath, error) : 0;
+    if (error) {
+        cout << "Failed to check " << runLogPath << ": " << error.message() << endl;
+        return;
+    }
+    bool fresh = size == 0;
+    ofstream log(runLogPath, ios::binary | ios::app);
+    if (!log) {
+        cout << "Failed to open " << runLogPath << endl;
+        return;
+    }
+    if (fresh) log.write(RUN_LOG_MAGIC, sizeof(RUN_LOG_MAGIC));
+    log.write(reinterpret_cast<const char*>(&run), sizeof(run));
+}
+
+void ScoreStore::replaceHighScore(int score) {
+    string tempPath = highScorePath + ".tmp";
+    {
+        ofstream file(tempPath, ios::trunc);
+        if (!file) return;
+        file << score;
+    }
+    error_code error;
+    filesystem::rename(tempPath, highScorePath, error);
+    if (error) cout << "Failed to save high score: " << error.message() << endl;
+}
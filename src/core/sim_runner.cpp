@@ -0,0 +1,120 @@
+#include "core/sim_runner.h"
+
+#include <chrono>
+#include "core/profiler.h"
+
+SimulationRunner::SimulationRunner(Simulation& sim, int tickRate, ReplayWriter* recorder)
+    : sim(sim), tickSeconds(1.0 / tickRate), recorder(recorder), steeringBudget(1000.0 * STEERING_BUDGET_TICK_FRACTION / tickRate) {}
+
+SimulationRunner::~SimulationRunner() {
+    stop();
+}
+
+int64_t SimulationRunner::clockNs() {
+    return chrono::duration_cast<chrono::nanoseconds>(chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+void SimulationRunner::start() {
+    if (worker.joinable()) return;
+    stopping = false;
+    publish(clockNs());
+    worker = thread([this] { run(); });
+}
+
+void SimulationRunner::stop() {
+    {
+        lock_guard<mutex> lock(inputLock);
+        stopping = true;
+    }
+    wake.notify_all();
+    if (worker.joinable()) worker.join();
+}
+
+void SimulationRunner::setInput(const SimInput& newInput) {
+    lock_guard<mutex> lock(inputLock);
+    input = newInput;
+}
+
+void SimulationRunner::command(SimCommand cmd) {
+    {
+        lock_guard<mutex> lock(inputLock);
+        commands.push_back(cmd);
+    }
+    commandsSent++;
+    wake.notify_all();
+}
+
+void SimulationRunner::publish(int64_t tickTimeNs) {
+    Snapshot& s = snapshots.back();
+    captureSnapshot(sim, s);
+    s.ticks = ticks;
+    s.tickTimeNs = tickTimeNs;
+    s.enemyHits = enemyHits;
+    s.pickups = pickups;
+    s.runsEnded = runsEnded;
+    s.lastRun = lastRun;
+    s.commandsApplied = commandsApplied;
+    snapshots.publish();
+}
+
+// Same fixed timestep as before the split: ticks of tickSeconds on a steady
+// schedule, with the backlog dropped after a stall of MAX_FRAME_SECONDS.
+void SimulationRunner::run() {
+    const int64_t tickNs = (int64_t)(tickSeconds * 1e9);
+    const int64_t maxLagNs = (int64_t)(MAX_FRAME_SECONDS * 1e9);
+    const chrono::steady_clock::time_point epoch;
+    int64_t nextTick = clockNs();
+    vector<SimCommand> pending;
+    SimInput current;
+
+    while (true) {
+        {
+            unique_lock<mutex> lock(inputLock);
+            auto ready = [this] { return stopping || !commands.empty(); };
+            if (sim.gameState == PLAYING) wake.wait_until(lock, epoch + chrono::nanoseconds(nextTick), ready);
+            else wake.wait(lock, ready);
+            if (stopping) return;
+            pending.swap(commands);
+            current = input;
+        }
+
+        for (SimCommand cmd : pending) {
+            if (recorder) recorder->command(cmd);
+            sim.apply(cmd);
+            commandsApplied++;
+        }
+        bool changed = !pending.empty();
+        pending.clear();
+
+        int64_t now = clockNs();
+        if (sim.gameState != PLAYING) {
+            nextTick = now;
+            if (changed) publish(now);
+            continue;
+        }
+        if (now - nextTick > maxLagNs) nextTick = now;
+
+        while (nextTick <= now && sim.gameState == PLAYING) {
+            PROFILE_ZONE("update");
+            if (recorder) recorder->tick(current);
+            sim.step(current, tickSeconds * 1000.0);
+            ticks++;
+            int slices = steeringBudget.update(sim.lastSteeringMs(), sim.steeringSlices());
+            if (slices != sim.steeringSlices()) {
+                SimCommand cmd = steeringSlicesCommand(slices);
+                if (recorder) recorder->command(cmd);
+                sim.apply(cmd);
+            }
+            enemyHits += sim.events.enemyHits;
+            pickups += sim.events.pickups;
+            if (sim.events.playerDied) {
+                runsEnded++;
+                // sim.wave already counts the next wave; record the last one reached, as the HUD shows.
+                lastRun = {sim.score, sim.wave - 1, sim.selectedWeapon, (uint32_t)sim.runDuration()};
+            }
+            nextTick += tickNs;
+            changed = true;
+        }
+        if (changed) publish(nextTick - tickNs);
+    }
+}
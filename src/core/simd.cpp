@@ -0,0 +1,28 @@
+#include "core/simd.h"
+
+SimdPath detectSimdPath() {
+#if defined(__SSE2__)
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2")) return SIMD_AVX2;
+    return SIMD_SSE2;
+#else
+    return SIMD_SCALAR;
+#endif
+}
+
+static SimdPath activePath = detectSimdPath();
+
+void setSimdPath(SimdPath path) {
+    SimdPath best = detectSimdPath();
+    activePath = path <= best ? path : best;
+}
+
+SimdPath simdPath() {
+    return activePath;
+}
+
+const char* simdPathName(SimdPath path) {
+    if (path == SIMD_AVX2) return "AVX2";
+    if (path == SIMD_SSE2) return "SSE2";
+    return "scalar";
+}
@@ -0,0 +1,493 @@
+#include "core/simulation.h"
+#include "core/profiler.h"
+#include "core/steering.h"
+#include "core/aabb.h"
+
+#include <cmath>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+
+// Smallest ranges worth handing to another thread.
+static const size_t STEERING_GRAIN = 2048;
+static const size_t BULLET_GRAIN = 256;
+// Enemies closer than this to the player have their heading refreshed every
+// tick whatever the steering slices. Covers every cell FlowField::nearTarget
+// accepts (within two cells per axis, so under 2.83 cells away).
+static const float STEERING_NEAR_BAND = 3.0f * FLOW_CELL_SIZE;
+
+Simulation::Simulation(uint64_t seed)
+    : bullets(MAX_BULLETS), wave(1), playerSpeed(PLAYER_START_SPEED), playerHealth(PLAYER_START_HEALTH),
+      playerDamage(PLAYER_START_DAMAGE), score(0), coins(0), timeMs(0), lastFireTime(0), runStartMs(0), pendingDamage(0),
+      rngSeed(seed), spawnRandom(seed, SPAWN_STREAM), waveRandom(seed, WAVE_STREAM), dropRandom(seed, DROP_STREAM),
+      spawnSampler({0, 0, SCREEN_WIDTH - 40, SCREEN_HEIGHT - 40}),
+      enemyGrid(GRID_CELL_SIZE, SCREEN_WIDTH, SCREEN_HEIGHT),
+      flowField(FLOW_CELL_SIZE, SCREEN_WIDTH, SCREEN_HEIGHT) {
+    player.rect = {SCREEN_WIDTH / 2, SCREEN_HEIGHT / 2, 40, 40};
+    player.speed = playerSpeed;
+}
+
+void Simulation::startGame() {
+    if (gameState != TITLE_SCREEN) return;
+    mode = MODE_WAVES;
+    gameState = WEAPON_SELECTION;
+}
+
+void Simulation::startHorde() {
+    if (gameState != TITLE_SCREEN) return;
+    mode = MODE_HORDE;
+    gameState = WEAPON_SELECTION;
+}
+
+void Simulation::selectWeapon(WeaponType weapon) {
+    if (gameState != WEAPON_SELECTION) return;
+    selectedWeapon = weapon;
+    gameState = PLAYING;
+    runStartMs = timeMs;
+}
+
+void Simulation::buyHealth() {
+    if (gameState == SHOP && coins >= 20) {
+        coins -= 20;
+        playerHealth += HEALTH_PACK_AMOUNT;
+    }
+}
+
+void Simulation::buyDamage() {
+    if (gameState == SHOP && coins >= 25) {
+        coins -= 25;
+        playerDamage += DAMAGE_UPGRADE_AMOUNT;
+    }
+}
+
+void Simulation::leaveShop() {
+    if (gameState == SHOP) gameState = PLAYING;
+}
+
+void Simulation::chooseUpgrade(int choice) {
+    if (gameState != UPGRADE_MENU) return;
+    if (choice == 1) {
+        playerSpeed += SPEED_UPGRADE_AMOUNT;
+    } else if (choice == 2) {
+        playerDamage += DAMAGE_UPGRADE_AMOUNT;
+    } else if (choice == 3) {
+        playerHealth += HEALTH_PACK_AMOUNT;
+    } else {
+        return;
+    }
+    gameState = PLAYING;
+}
+
+void Simulation::returnToTitle() {
+    if (gameState != GAME_OVER) return;
+    resetGame();
+    gameState = TITLE_SCREEN;
+}
+
+void Simulation::abandonRun() {
+    if (gameState != PLAYING) return;
+    resetGame();
+    gameState = TITLE_SCREEN;
+}
+
+void Simulation::apply(SimCommand command) {
+    switch (command) {
+        case CMD_START_GAME: startGame(); break;
+        case CMD_SELECT_PISTOL: selectWeapon(PISTOL); break;
+        case CMD_SELECT_SHOTGUN: selectWeapon(SHOTGUN); break;
+        case CMD_BUY_HEALTH: buyHealth(); break;
+        case CMD_BUY_DAMAGE: buyDamage(); break;
+        case CMD_LEAVE_SHOP: leaveShop(); break;
+        case CMD_UPGRADE_SPEED: chooseUpgrade(1); break;
+        case CMD_UPGRADE_DAMAGE: chooseUpgrade(2); break;
+        case CMD_UPGRADE_HEALTH: chooseUpgrade(3); break;
+        case CMD_RETURN_TO_TITLE: returnToTitle(); break;
+        case CMD_START_HORDE: startHorde(); break;
+        case CMD_ABANDON_RUN: abandonRun(); break;
+        case CMD_STEER_SLICES_1: setSteeringSlices(1); break;
+        case CMD_STEER_SLICES_2: setSteeringSlices(2); break;
+        case CMD_STEER_SLICES_4: setSteeringSlices(4); break;
+        case CMD_STEER_SLICES_8: setSteeringSlices(8); break;
+        default: break;
+    }
+}
+
+// Rounded down to a power of two, so the round robin is a mask.
+void Simulation::setSteeringSlices(int n) {
+    slices = 1;
+    while (slices * 2 <= n && slices < MAX_STEERING_SLICES) slices *= 2;
+}
+
+// Anywhere in the arena except the square of SPAWN_SAFE_RADIUS around the player.
+Vec2 Simulation::randomSafeSpawn(Random& random) {
+    return spawnSampler.sample(random, player.rect.x, player.rect.y, SPAWN_SAFE_RADIUS);
+}
+
+void Simulation::shootBullet(float mouseX, float mouseY) {
+    switch (selectedWeapon) {
+        case PISTOL: {
+            float x = player.rect.x + player.rect.w / 2 - 5;
+            float y = player.rect.y + player.rect.h / 2 - 5;
+            double length = sqrt(pow(mouseX - x, 2) + pow(mouseY - y, 2));
+            // Aiming at the muzzle itself has no direction; the shot fizzles.
+            if (length == 0) break;
+            Bullet* bullet = bullets.spawn();
+            if (!bullet) break;
+            bullet->rect = {x, y, 10, 10};
+            bullet->prev = {x, y};
+            bullet->dx = (mouseX - x) / length;
+            bullet->dy = (mouseY - y) / length;
+            bullet->speed = 8.0f;
+            bullet->type = Bullet::PISTOL;
+            break;
+        }
+        case SHOTGUN: {
+            for (int i = - SHOTGUN_BULLET_COUNT / 2; i <= SHOTGUN_BULLET_COUNT / 2; i++) {
+                Bullet* bullet = bullets.spawn();
+                if (!bullet) break;
+                bullet->rect = {player.rect.x + player.rect.w / 2 - 5, player.rect.y + player.rect.h / 2 - 5, 10, 10};
+                bullet->prev = {bullet->rect.x, bullet->rect.y};
+                double angle = atan2(mouseY - bullet->rect.y, mouseX - bullet->rect.x);
+                angle += i * SHOTGUN_SPREAD_ANGLE / 100.0;
+                bullet->dx = cos(angle);
+                bullet->dy = sin(angle);
+                bullet->speed = 7.0f;
+                bullet->type = Bullet::SHOTGUN;
+            }
+            break;
+        }
+    }
+    lastFireTime = timeMs;
+}
+
+void Simulation::spawnEnemy(EnemyType type, int level) {
+    Vec2 spawn = randomSafeSpawn(spawnRandom);
+    int health = 0, speed = 0, size = 30;
+
+    if (type == BASIC) {
+        health = ENEMY_BASIC.health + level * 2;
+        speed = ENEMY_BASIC.speed + level / 5;
+        size = ENEMY_BASIC.size;
+    } else if (type == FAST) {
+        speed = ENEMY_FAST.speed + level / 3;
+        health = ENEMY_FAST.health + level;
+        size = ENEMY_FAST.size;
+    } else if (type == TANK) {
+        speed = ENEMY_TANK.speed + level / 10;
+        health = ENEMY_TANK.health + level * 5;
+        size = ENEMY_TANK.size;
+    }
+    enemies.add(spawn.x, spawn.y, size, size, speed, health, type);
+}
+
+// Draws the wave's composition now but only queues it; spawnQueued() brings
+// the enemies in a few per tick. Room for all of them is reserved up front.
+void Simulation::spawnWave() {
+    enemies.clear();
+    enemies.reserve(wave * 5);
+    spawnQueue.clear();
+    spawnQueue.reserve(wave * 5);
+    for (int i = 0; i < wave * 5; i++) spawnQueue.push_back(static_cast<EnemyType>(waveRandom.below(3)));
+    spawnHead = 0;
+    queuedLevel = wave;
+    spawnAllowance = 0;
+    if (dropRandom.below(5) == 0) {
+        PowerUp p;
+        Vec2 spawn = randomSafeSpawn(dropRandom);
+        p.rect = {spawn.x, spawn.y, 20, 20};
+        p.type = (dropRandom.below(2) == 0) ? PowerUp::HEALTH : PowerUp::SPEED;
+        powerUps.push_back(p);
+    }
+}
+
+// Spawns up to WAVE_SPAWNS_PER_TICK queued enemies per reference tick.
+void Simulation::spawnQueued(float move) {
+    if (spawnHead == spawnQueue.size()) return;
+    spawnAllowance += WAVE_SPAWNS_PER_TICK * move;
+    for (; spawnHead < spawnQueue.size() && spawnAllowance >= 1; spawnHead++) {
+        spawnEnemy(spawnQueue[spawnHead], queuedLevel);
+        spawnAllowance -= 1;
+    }
+}
+
+// Replaces the enemies that died and tops the bullets back up with shots
+// spread around the player at the golden angle, so they fan out evenly.
+void Simulation::fillHorde() {
+    enemies.reserve(HORDE_ENEMIES);
+    while ((int)enemies.size() < HORDE_ENEMIES) spawnEnemy(static_cast<EnemyType>(waveRandom.below(3)), wave);
+
+    float x = player.rect.x + player.rect.w / 2 - 5;
+    float y = player.rect.y + player.rect.h / 2 - 5;
+    while (bullets.size() < HORDE_BULLETS) {
+        Bullet* bullet = bullets.spawn();
+        if (!bullet) break;
+        double angle = fmod(hordeShots++ * 2.399963229728653, 2 * M_PI);
+        bullet->rect = {x, y, 10, 10};
+        bullet->prev = {x, y};
+        bullet->dx = (float)cos(angle);
+        bullet->dy = (float)sin(angle);
+        bullet->speed = 8.0f;
+        bullet->type = Bullet::PISTOL;
+    }
+}
+
+void Simulation::resetGame() {
+    playerHealth = 100;
+    score = -200;
+    wave = 1;
+    spawnQueue.clear();
+    spawnHead = 0;
+    enemies.clear();
+    bullets.clear();
+    coinsOnGround.clear();
+    powerUps.clear();
+}
+
+Rect Simulation::enemyRect(size_t i) const {
+    return {enemies.x[i], enemies.y[i], enemies.w[i], enemies.h[i]};
+}
+
+void Simulation::playerHits(const float* x, const float* y, const float* w, const float* h, size_t count) {
+    hitBits.resize(hitWords(count));
+    stats.narrowPhaseTests += (int)count;
+    overlapMask(player.rect, x, y, w, h, count, hitBits.data());
+}
+
+void Simulation::playerHits(const Rect* first, size_t stride, size_t count) {
+    hitBits.resize(hitWords(count));
+    stats.narrowPhaseTests += (int)count;
+    overlapMaskStrided(player.rect, first, stride, count, hitBits.data());
+}
+
+int Simulation::firstEnemyHit(const Rect& r, const vector<bool>* dead, int& tests) const {
+    int target = -1;
+    enemyGrid.forEachCandidate(r.x, r.y, r.w, r.h, [&](int i) {
+        if ((dead && (*dead)[i]) || (target != -1 && i >= target)) return;
+        tests++;
+        if (intersects(r, enemyRect(i))) target = i;
+    });
+    return target;
+}
+
+void Simulation::step(const SimInput& input, double dtMs) {
+    PROFILE_ZONE("step");
+    events = SimEvents();
+    timeMs += dtMs;
+
+    if (playerHealth <= 0) {
+        events.playerDied = true;
+        gameState = GAME_OVER;
+    }
+    if (gameState != PLAYING) return;
+
+    float move = (float)(dtMs / SIM_REFERENCE_TICK_MS);
+    player.prev = {player.rect.x, player.rect.y};
+    enemies.savePositions();
+
+    if (input.up) player.rect.y -= player.speed * move;
+    if (input.down) player.rect.y += player.speed * move;
+    if (input.left) player.rect.x -= player.speed * move;
+    if (input.right) player.rect.x += player.speed * move;
+
+    keepInside(player.rect, SCREEN_WIDTH, SCREEN_HEIGHT);
+    spawnQueued(move);
+    stats.narrowPhaseTests = 0;
+    stats.bruteForceTests = (int)(enemies.size() * (bullets.size() + 1) + coinsOnGround.size() + powerUps.size());
+
+    {
+        PROFILE_ZONE("steering");
+        auto steeringStart = chrono::steady_clock::now();
+        flowField.update(player.rect.x, player.rect.y);
+
+        // Enemies follow the shared flow field and head straight for the
+        // player once they are within a cell of it. Targets are gathered
+        // first so the headings are computed in one vectorized pass; with
+        // slices > 1 only the enemies due this tick (their turn in the round
+        // robin, or near the player) are gathered, compacted to the front of
+        // the chunk. Every enemy then moves by its step.
+        size_t count = enemies.size();
+        steerTargetX.resize(count);
+        steerTargetY.resize(count);
+        float* ex = enemies.x.data();
+        float* ey = enemies.y.data();
+        float* vx = enemies.vx.data();
+        float* vy = enemies.vy.data();
+        const float* speed = enemies.speed.data();
+        if (slices > 1) {
+            steerX.resize(count);
+            steerY.resize(count);
+            steerSpeed.resize(count);
+            steerVX.resize(count);
+            steerVY.resize(count);
+            steerIndex.resize(count);
+        }
+        uint32_t tick = steerTick++;
+        parallelFor(count, STEERING_GRAIN, [&](size_t begin, size_t end) {
+            if (slices == 1) {
+                for (size_t i = begin; i < end; i++) {
+                    Vec2 target = flowField.nearTarget(ex[i], ey[i]) ? Vec2{player.rect.x, player.rect.y}
+                                                                     : flowField.waypoint(ex[i], ey[i]);
+                    steerTargetX[i] = target.x;
+                    steerTargetY[i] = target.y;
+                }
+                steer(ex + begin, ey + begin, steerTargetX.data() + begin, steerTargetY.data() + begin, speed + begin,
+                      move, vx + begin, vy + begin, end - begin);
+            } else {
+                size_t due = begin;
+                size_t sliceMask = slices - 1;
+                for (size_t i = begin; i < end; i++) {
+                    float dx = ex[i] - player.rect.x;
+                    float dy = ey[i] - player.rect.y;
+                    bool stale = ((i + tick) & sliceMask) == 0 || (vx[i] == 0 && vy[i] == 0) ||
+                                 dx * dx + dy * dy < STEERING_NEAR_BAND * STEERING_NEAR_BAND;
+                    if (!stale) continue;
+                    Vec2 target = flowField.nearTarget(ex[i], ey[i]) ? Vec2{player.rect.x, player.rect.y}
+                                                                     : flowField.waypoint(ex[i], ey[i]);
+                    steerIndex[due] = (uint32_t)i;
+                    steerX[due] = ex[i];
+                    steerY[due] = ey[i];
+                    steerSpeed[due] = speed[i];
+                    steerTargetX[due] = target.x;
+                    steerTargetY[due] = target.y;
+                    due++;
+                }
+                steer(steerX.data() + begin, steerY.data() + begin, steerTargetX.data() + begin, steerTargetY.data() + begin,
+                      steerSpeed.data() + begin, move, steerVX.data() + begin, steerVY.data() + begin, due - begin);
+                for (size_t k = begin; k < due; k++) {
+                    vx[steerIndex[k]] = steerVX[k];
+                    vy[steerIndex[k]] = steerVY[k];
+                }
+            }
+            for (size_t i = begin; i < end; i++) {
+                ex[i] += vx[i];
+                ey[i] += vy[i];
+            }
+        });
+        steeringMs = chrono::duration<double, milli>(chrono::steady_clock::now() - steeringStart).count();
+    }
+
+    {
+        PROFILE_ZONE("collision");
+        enemyGrid.clear();
+        for (size_t i = 0; i < enemies.size(); i++) {
+            enemyGrid.insert((int)i, enemies.x[i], enemies.y[i], enemies.w[i], enemies.h[i]);
+        }
+        enemyGrid.build();
+
+        // Contact damage is per reference tick, so it accumulates fractionally at higher tick rates.
+        playerHits(enemies.x.data(), enemies.y.data(), enemies.w.data(), enemies.h.data(), enemies.size());
+        forEachHit(hitBits.data(), enemies.size(), [&](size_t i) {
+            if (mode != MODE_WAVES) return;
+            pendingDamage += ((enemies.type[i] == TANK) ? 3 : 1) * move;
+            events.enemyHits++;
+        });
+        int damage = (int)pendingDamage;
+        playerHealth -= damage;
+        pendingDamage -= damage;
+    }
+
+    {
+        PROFILE_ZONE("bullets");
+        if (timeMs - lastFireTime > fireCooldown && input.fire) {
+            shootBullet(input.aimX, input.aimY);
+        }
+
+        // Bullets move in parallel; the pool's free list is only touched afterwards.
+        int bulletEnd = bullets.end();
+        bulletGone.assign(bulletEnd, 0);
+        parallelFor(bulletEnd, BULLET_GRAIN, [&](size_t begin, size_t end) {
+            for (size_t i = begin; i < end; i++) {
+                if (!bullets.isAlive((int)i)) continue;
+                Bullet& b = bullets[(int)i];
+                b.prev = {b.rect.x, b.rect.y};
+                b.rect.x += b.dx * b.speed * move;
+                b.rect.y += b.dy * b.speed * move;
+                // Written as not-inside so a NaN position counts as gone.
+                bulletGone[i] = !(b.rect.x >= -10 && b.rect.x <= SCREEN_WIDTH && b.rect.y >= -10 && b.rect.y <= SCREEN_HEIGHT);
+            }
+        });
+        for (int i = 0; i < bulletEnd; i++) {
+            if (bulletGone[i]) bullets.despawn(i);
+        }
+    }
+
+    {
+        PROFILE_ZONE("collision");
+        // A bullet hits the first live enemy (in store order) it overlaps.
+        // The broadphase runs in parallel and ignores kills from this tick;
+        // resolving in bullet order re-queries only when an earlier bullet
+        // killed that enemy, so the outcome matches a serial pass.
+        // Killed enemies are only marked here and swap-removed after the pass.
+        int bulletEnd = bullets.end();
+        bulletTarget.assign(bulletEnd, -1);
+        atomic<int> tests{0};
+        parallelFor(bulletEnd, BULLET_GRAIN, [&](size_t begin, size_t end) {
+            int chunkTests = 0;
+            for (size_t b = begin; b < end; b++) {
+                if (bullets.isAlive((int)b)) bulletTarget[b] = firstEnemyHit(bullets[(int)b].rect, nullptr, chunkTests);
+            }
+            tests += chunkTests;
+        });
+        int serialTests = 0;
+
+        enemyDead.assign(enemies.size(), false);
+        for (int b = 0; b < bulletEnd; b++) {
+            int target = bulletTarget[b];
+            if (target != -1 && enemyDead[target]) target = firstEnemyHit(bullets[b].rect, &enemyDead, serialTests);
+
+            if (target != -1) {
+                enemies.health[target] -= playerDamage;
+                if (enemies.health[target] <= 0) {
+                    score += 10;
+                    // Nothing collects coins fast enough in horde mode.
+                    if (mode == MODE_WAVES) {
+                        Coin c;
+                        c.rect = {enemies.x[target] + enemies.w[target] / 2, enemies.y[target] + enemies.h[target] / 2, 15, 15};
+                        coinsOnGround.push_back(c);
+                    }
+                    enemyDead[target] = true;
+                }
+                bullets.despawn(b);
+            }
+        }
+        stats.narrowPhaseTests += tests + serialTests;
+        for (size_t i = enemies.size(); i-- > 0;) {
+            if (enemyDead[i]) enemies.remove(i);
+        }
+    }
+
+    {
+        PROFILE_ZONE("pickups");
+        pickedUp.clear();
+        playerHits(powerUps.empty() ? nullptr : &powerUps[0].rect, sizeof(PowerUp), powerUps.size());
+        forEachHit(hitBits.data(), powerUps.size(), [&](size_t i) { pickedUp.push_back((int)i); });
+        for (int i = (int)pickedUp.size() - 1; i >= 0; i--) {
+            PowerUp& p = powerUps[pickedUp[i]];
+            events.pickups++;
+            if (p.type == PowerUp::HEALTH) playerHealth += 20;
+            else if (p.type == PowerUp::SPEED) player.speed += 2;
+            powerUps.erase(powerUps.begin() + pickedUp[i]);
+        }
+
+        pickedUp.clear();
+        playerHits(coinsOnGround.empty() ? nullptr : &coinsOnGround[0].rect, sizeof(Coin), coinsOnGround.size());
+        forEachHit(hitBits.data(), coinsOnGround.size(), [&](size_t i) { pickedUp.push_back((int)i); });
+        for (int i = (int)pickedUp.size() - 1; i >= 0; i--) {
+            coins += COIN_VALUE;
+            coinsOnGround.erase(coinsOnGround.begin() + pickedUp[i]);
+        }
+    }
+
+    if (mode == MODE_HORDE) {
+        fillHorde();
+    } else if (enemies.empty() && spawnHead == spawnQueue.size()) {
+        if (wave % 3 == 0) gameState = UPGRADE_MENU;
+        if (wave % 5 == 0) {
+            gameState = SHOP;
+        }
+        spawnWave();
+        wave++;
+        player.speed = playerSpeed;
+        score += 100 * wave;
+    }
+}
@@ -0,0 +1,44 @@
+#include "core/snapshot.h"
+#include "core/profiler.h"
+
+void captureSnapshot(const Simulation& sim, Snapshot& out) {
+    PROFILE_ZONE("snapshot");
+    out.gameState = sim.gameState;
+    out.selectedWeapon = sim.selectedWeapon;
+
+    HudValues& hud = out.hud;
+    hud.health = sim.playerHealth;
+    hud.wave = sim.wave;
+    hud.score = sim.score;
+    hud.coins = sim.coins;
+    hud.enemies = (int)sim.enemies.size();
+    hud.bullets = sim.bullets.size();
+    hud.coinsOnGround = (int)sim.coinsOnGround.size();
+    hud.powerUps = (int)sim.powerUps.size();
+    hud.stats = sim.stats;
+
+    vector<SpriteInstance>& sprites = out.sprites;
+    sprites.clear();
+    if (sim.gameState != PLAYING) return;
+
+    for (const Coin& c : sim.coinsOnGround) {
+        sprites.push_back({c.rect, {c.rect.x, c.rect.y}, SPRITE_COIN});
+    }
+
+    const EnemyStore& enemies = sim.enemies;
+    for (size_t i = 0; i < enemies.size(); i++) {
+        sprites.push_back({{enemies.x[i], enemies.y[i], enemies.w[i], enemies.h[i]},
+                           {enemies.prevX[i], enemies.prevY[i]}, SPRITE_ENEMY});
+    }
+
+    const Pool<Bullet>& bullets = sim.bullets;
+    for (int i = 0; i < bullets.end(); i++) {
+        if (bullets.isAlive(i)) sprites.push_back({bullets[i].rect, bullets[i].prev, SPRITE_BULLET});
+    }
+
+    for (const PowerUp& p : sim.powerUps) {
+        sprites.push_back({p.rect, {p.rect.x, p.rect.y}, SPRITE_POWERUP});
+    }
+
+    sprites.push_back({sim.player.rect, sim.player.prev, SPRITE_PLAYER});
+}
@@ -0,0 +1,82 @@
+#include "core/steering.h"
+#include "core/simd.h"
+
+#include <cmath>
+
+#if defined(__SSE2__)
+#define STEERING_X86 1
+#include <immintrin.h>
+#endif
+
+void steerScalar(const float* x, const float* y, const float* targetX, const float* targetY, const float* speed, float move,
+                 float* vx, float* vy, size_t count) {
+    for (size_t i = 0; i < count; i++) {
+        float dx = targetX[i] - x[i];
+        float dy = targetY[i] - y[i];
+        float lengthSquared = dx * dx + dy * dy;
+        float step = lengthSquared > 0 ? speed[i] * move / sqrtf(lengthSquared) : 0.0f;
+        vx[i] = dx * step;
+        vy[i] = dy * step;
+    }
+}
+
+#ifdef STEERING_X86
+void steerSSE2(const float* x, const float* y, const float* targetX, const float* targetY, const float* speed, float move,
+               float* vx, float* vy, size_t count) {
+    const __m128 zero = _mm_setzero_ps();
+    const __m128 moveScale = _mm_set1_ps(move);
+    size_t i = 0;
+    for (; i + 4 <= count; i += 4) {
+        __m128 px = _mm_loadu_ps(x + i);
+        __m128 py = _mm_loadu_ps(y + i);
+        __m128 dx = _mm_sub_ps(_mm_loadu_ps(targetX + i), px);
+        __m128 dy = _mm_sub_ps(_mm_loadu_ps(targetY + i), py);
+        __m128 d2 = _mm_add_ps(_mm_mul_ps(dx, dx), _mm_mul_ps(dy, dy));
+        // Zero length gives 0 / 0 = NaN; the mask zeroes the step instead.
+        __m128 step = _mm_div_ps(_mm_mul_ps(_mm_loadu_ps(speed + i), moveScale), _mm_sqrt_ps(d2));
+        step = _mm_and_ps(step, _mm_cmpgt_ps(d2, zero));
+        _mm_storeu_ps(vx + i, _mm_mul_ps(dx, step));
+        _mm_storeu_ps(vy + i, _mm_mul_ps(dy, step));
+    }
+    steerScalar(x + i, y + i, targetX + i, targetY + i, speed + i, move, vx + i, vy + i, count - i);
+}
+
+__attribute__((target("avx2")))
+void steerAVX2(const float* x, const float* y, const float* targetX, const float* targetY, const float* speed, float move,
+               float* vx, float* vy, size_t count) {
+    const __m256 zero = _mm256_setzero_ps();
+    const __m256 moveScale = _mm256_set1_ps(move);
+    size_t i = 0;
+    for (; i + 8 <= count; i += 8) {
+        __m256 px = _mm256_loadu_ps(x + i);
+        __m256 py = _mm256_loadu_ps(y + i);
+        __m256 dx = _mm256_sub_ps(_mm256_loadu_ps(targetX + i), px);
+        __m256 dy = _mm256_sub_ps(_mm256_loadu_ps(targetY + i), py);
+        __m256 d2 = _mm256_add_ps(_mm256_mul_ps(dx, dx), _mm256_mul_ps(dy, dy));
+        __m256 step = _mm256_div_ps(_mm256_mul_ps(_mm256_loadu_ps(speed + i), moveScale), _mm256_sqrt_ps(d2));
+        step = _mm256_and_ps(step, _mm256_cmp_ps(d2, zero, _CMP_GT_OQ));
+        _mm256_storeu_ps(vx + i, _mm256_mul_ps(dx, step));
+        _mm256_storeu_ps(vy + i, _mm256_mul_ps(dy, step));
+    }
+    steerSSE2(x + i, y + i, targetX + i, targetY + i, speed + i, move, vx + i, vy + i, count - i);
+}
+
+#else
+void steerSSE2(const float* x, const float* y, const float* targetX, const float* targetY, const float* speed, float move,
+               float* vx, float* vy, size_t count) {
+    steerScalar(x, y, targetX, targetY, speed, move, vx, vy, count);
+}
+
+void steerAVX2(const float* x, const float* y, const float* targetX, const float* targetY, const float* speed, float move,
+               float* vx, float* vy, size_t count) {
+    steerScalar(x, y, targetX, targetY, speed, move, vx, vy, count);
+}
+#endif
+
+void steer(const float* x, const float* y, const float* targetX, const float* targetY, const float* speed, float move,
+           float* vx, float* vy, size_t count) {
+    SimdPath path = simdPath();
+    if (path == SIMD_AVX2) steerAVX2(x, y, targetX, targetY, speed, move, vx, vy, count);
+    else if (path == SIMD_SSE2) steerSSE2(x, y, targetX, targetY, speed, move, vx, vy, count);
+    else steerScalar(x, y, targetX, targetY, speed, move, vx, vy, count);
+}
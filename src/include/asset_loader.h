@@ -0,0 +1,125 @@
+#ifndef ASSET_LOADER_H
+#define ASSET_LOADER_H
+
+#include <SDL2/SDL.h>
+#include <SDL2/SDL_image.h>
+#include <SDL2/SDL_mixer.h>
+#include <vector>
+#include <string>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <algorithm>
+#include <iostream>
+
+using namespace std;
+
+// Decodes images into SDL_Surfaces (and sounds into Mix_Chunks/Mix_Music) on a
+// pool of worker threads. Jobs are picked up in the order they were added, so
+// whatever the first frame needs should be added first. Creating textures
+// from the surfaces is left to the render thread.
+//
+// IMG_Init/Mix_Init for the formats in use must be called before start():
+// their lazy initialisation is not thread-safe.
+class AssetLoader {
+public:
+    enum Kind { IMAGE, SOUND, MUSIC };
+
+    ~AssetLoader() {
+        join();
+        for (Job& job : jobs) {
+            if (job.surface) SDL_FreeSurface(job.surface);
+        }
+    }
+
+    // Returns a handle for wait()/surface()/chunk()/music().
+    int add(Kind kind, const string& path) {
+        jobs.push_back(Job{kind, path});
+        return (int)jobs.size() - 1;
+    }
+
+    void start(int workerCount) {
+        workerCount = max(1, min(workerCount, (int)jobs.size()));
+        for (int i = 0; i < workerCount; i++) {
+            workers.emplace_back([this] { work(); });
+        }
+    }
+
+    // Blocks until the job has finished; returns false if it failed.
+    bool wait(int handle) {
+        unique_lock<mutex> lock(doneMutex);
+        doneChanged.wait(lock, [&] { return jobs[handle].done; });
+        return jobs[handle].ok;
+    }
+
+    bool allDone() {
+        lock_guard<mutex> lock(doneMutex);
+        return finished == (int)jobs.size();
+    }
+
+    // Waits for every job; returns false if any failed.
+    bool waitAll() {
+        bool ok = true;
+        for (int i = 0; i < (int)jobs.size(); i++) ok = wait(i) && ok;
+        return ok;
+    }
+
+    void join() {
+        for (thread& worker : workers) worker.join();
+        workers.clear();
+    }
+
+    // Ownership stays with the loader; surfaces are freed when it is destroyed.
+    // Handles that were never added (e.g. -1) give nullptr.
+    SDL_Surface* surface(int handle) const { return valid(handle) ? jobs[handle].surface : nullptr; }
+    // Ownership passes to the caller.
+    Mix_Chunk* chunk(int handle) const { return valid(handle) ? jobs[handle].chunk : nullptr; }
+    Mix_Music* music(int handle) const { return valid(handle) ? jobs[handle].music : nullptr; }
+
+private:
+    struct Job {
+        Kind kind;
+        string path;
+        SDL_Surface* surface = nullptr;
+        Mix_Chunk* chunk = nullptr;
+        Mix_Music* music = nullptr;
+        bool ok = false;
+        bool done = false;
+    };
+
+    vector<Job> jobs;
+    vector<thread> workers;
+    atomic<int> next{0};
+    mutex doneMutex;
+    condition_variable doneChanged;
+    int finished = 0;
+
+    bool valid(int handle) const { return handle >= 0 && handle < (int)jobs.size(); }
+
+    void work() {
+        for (int i = next++; i < (int)jobs.size(); i = next++) {
+            Job& job = jobs[i];
+            bool ok = false;
+            if (job.kind == IMAGE) {
+                job.surface = IMG_Load(job.path.c_str());
+                ok = job.surface != nullptr;
+            } else if (job.kind == SOUND) {
+                job.chunk = Mix_LoadWAV(job.path.c_str());
+                ok = job.chunk != nullptr;
+            } else {
+                job.music = Mix_LoadMUS(job.path.c_str());
+                ok = job.music != nullptr;
+            }
+            if (!ok) cout << "Failed to load " << job.path << ": " << SDL_GetError() << endl;
+
+            lock_guard<mutex> lock(doneMutex);
+            job.ok = ok;
+            job.done = true;
+            finished++;
+            doneChanged.notify_all();
+        }
+    }
+};
+
+#endif
@@ -20,4 +20,25 @@ const int SHOTGUN_BULLET_COUNT = 3;
 const int PLAYER_SPRITE_WIDTH = 64;
 const int PLAYER_SPRITE_HEIGHT = 64;
 
+const int GRID_CELL_SIZE = 64;
+const int FLOW_CELL_SIZE = 32;
+const int MAX_BULLETS = 2048;
+const int WAVE_SPAWNS_PER_TICK = 4;  // per SIM_REFERENCE_TICK_MS
+
+// Horde mode: the stress target the simulation has to hold at 60 ticks/s.
+const int HORDE_ENEMIES = 10000;
+const int HORDE_BULLETS = 2000;
+
+const int DEFAULT_TICK_RATE = 60;
+const double STEERING_BUDGET_TICK_FRACTION = 0.125;  // of a tick, for the steering zone alone
+const double SIM_REFERENCE_TICK_MS = 1000.0 / 60;
+const double MAX_FRAME_SECONDS = 0.25;
+const int HEADLESS_DEFAULT_TICKS = 36000;
+const unsigned long long HEADLESS_DEFAULT_SEED = 1;
+const int MENU_IDLE_WAIT_MS = 250;
+
+const char* const HIGH_SCORE_PATH = "highscore.txt";
+const char* const RUN_LOG_PATH = "runs.bin";
+const int GAME_OVER_TOP_RUNS = 3;
+
 #endif
\ No newline at end of file
@@ -0,0 +1,36 @@
+#ifndef CORE_AABB_H
+#define CORE_AABB_H
+
+#include <cstddef>
+#include <cstdint>
+#include "core/math.h"
+
+// Batched overlap tests of one rect against many, with the same semantics as
+// intersects(). hits receives one bit per rect (bit i % 64 of word i / 64)
+// and must hold hitWords(count) words. Each returns the number of overlaps.
+inline size_t hitWords(size_t count) {
+    return (count + 63) / 64;
+}
+
+// Rects stored as separate x/y/w/h arrays (e.g. EnemyStore).
+size_t overlapMaskScalar(const Rect& rect, const float* x, const float* y, const float* w, const float* h, size_t count, uint64_t* hits);
+size_t overlapMaskSSE2(const Rect& rect, const float* x, const float* y, const float* w, const float* h, size_t count, uint64_t* hits);
+size_t overlapMaskAVX2(const Rect& rect, const float* x, const float* y, const float* w, const float* h, size_t count, uint64_t* hits);
+// Runs the kernel for the current simdPath().
+size_t overlapMask(const Rect& rect, const float* x, const float* y, const float* w, const float* h, size_t count, uint64_t* hits);
+
+// Rects embedded in structs (Coin, PowerUp): first points at the first Rect,
+// stride is the struct size in bytes. SIMD paths transpose four rects at a time.
+size_t overlapMaskStrided(const Rect& rect, const Rect* first, size_t stride, size_t count, uint64_t* hits);
+
+// Calls visit(i) for every set bit, in increasing i.
+template <typename Visit>
+void forEachHit(const uint64_t* hits, size_t count, Visit&& visit) {
+    for (size_t word = 0; word < hitWords(count); word++) {
+        for (uint64_t bits = hits[word]; bits != 0; bits &= bits - 1) {
+            visit(word * 64 + __builtin_ctzll(bits));
+        }
+    }
+}
+
+#endif
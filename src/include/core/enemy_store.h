@@ -0,0 +1,80 @@
+#ifndef CORE_ENEMY_STORE_H
+#define CORE_ENEMY_STORE_H
+
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+
+using namespace std;
+
+enum EnemyType : uint8_t { BASIC, FAST, TANK };
+
+// Enemies stored as structure-of-arrays so each pass only walks the columns
+// it needs. Removal swaps the last enemy into the hole, so indices are not
+// stable across remove(). prevX/prevY hold the position before the last step
+// for render interpolation; vx/vy the per-tick step from the last time the
+// enemy's steering was refreshed (zero until then).
+class EnemyStore {
+public:
+    vector<float> x, y, w, h;
+    vector<float> prevX, prevY;
+    vector<float> vx, vy;
+    vector<float> speed;
+    vector<int> health;
+    vector<EnemyType> type;
+
+    size_t size() const { return x.size(); }
+    bool empty() const { return x.empty(); }
+
+    void reserve(size_t n) {
+        x.reserve(n); y.reserve(n); w.reserve(n); h.reserve(n);
+        prevX.reserve(n); prevY.reserve(n);
+        vx.reserve(n); vy.reserve(n);
+        speed.reserve(n);
+        health.reserve(n);
+        type.reserve(n);
+    }
+
+    void clear() {
+        x.clear(); y.clear(); w.clear(); h.clear();
+        prevX.clear(); prevY.clear();
+        vx.clear(); vy.clear();
+        speed.clear();
+        health.clear();
+        type.clear();
+    }
+
+    void add(float ex, float ey, float ew, float eh, float espeed, int ehealth, EnemyType etype) {
+        x.push_back(ex); y.push_back(ey); w.push_back(ew); h.push_back(eh);
+        prevX.push_back(ex); prevY.push_back(ey);
+        vx.push_back(0); vy.push_back(0);
+        speed.push_back(espeed);
+        health.push_back(ehealth);
+        type.push_back(etype);
+    }
+
+    void remove(size_t i) {
+        size_t last = size() - 1;
+        if (i != last) {
+            x[i] = x[last]; y[i] = y[last]; w[i] = w[last]; h[i] = h[last];
+            prevX[i] = prevX[last]; prevY[i] = prevY[last];
+            vx[i] = vx[last]; vy[i] = vy[last];
+            speed[i] = speed[last];
+            health[i] = health[last];
+            type[i] = type[last];
+        }
+        x.pop_back(); y.pop_back(); w.pop_back(); h.pop_back();
+        prevX.pop_back(); prevY.pop_back();
+        vx.pop_back(); vy.pop_back();
+        speed.pop_back();
+        health.pop_back();
+        type.pop_back();
+    }
+
+    void savePositions() {
+        prevX = x;
+        prevY = y;
+    }
+};
+
+#endif
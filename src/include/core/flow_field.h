@@ -0,0 +1,156 @@
+#ifndef CORE_FLOW_FIELD_H
+#define CORE_FLOW_FIELD_H
+
+#include <vector>
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <climits>
+#include "core/math.h"
+
+using namespace std;
+
+// Navigation grid shared by every enemy. update() runs Dijkstra (8-connected,
+// no corner cutting, bucket queue) from the target's cell, but only when the
+// target entered another cell or the blocked cells changed. Each reachable cell
+// then stores a waypoint, the centre of its downhill neighbour, which enemies
+// look up in O(1).
+class FlowField {
+public:
+    FlowField(int cellSize, int width, int height)
+        : cellSize(cellSize),
+          cols((width + cellSize - 1) / cellSize),
+          rows((height + cellSize - 1) / cellSize),
+          stride(cols + 2),
+          blocked(stride * (rows + 2), 1),
+          distance(stride * (rows + 2), INT_MAX),
+          waypoints(stride * (rows + 2), Vec2{0, 0}) {
+        // Cells are stored with a blocked border so neighbour lookups need no bounds checks.
+        for (int cy = 0; cy < rows; cy++) {
+            for (int cx = 0; cx < cols; cx++) blocked[index(cx, cy)] = 0;
+        }
+        int offsets[8][2] = {{1, 0}, {-1, 0}, {0, 1}, {0, -1}, {1, 1}, {1, -1}, {-1, 1}, {-1, -1}};
+        for (int i = 0; i < 8; i++) {
+            neighbours[i] = {offsets[i][1] * stride + offsets[i][0], offsets[i][0], offsets[i][1],
+                             i < 4 ? STRAIGHT_COST : DIAGONAL_COST};
+        }
+    }
+
+    // For level geometry; takes effect on the next update().
+    void setBlocked(int cx, int cy, bool isBlocked) {
+        if (cx < 0 || cy < 0 || cx >= cols || cy >= rows) return;
+        blocked[index(cx, cy)] = isBlocked;
+        dirty = true;
+    }
+
+    // Returns true if the field was recomputed.
+    bool update(float targetX, float targetY) {
+        int tx = clampCol(cellOf(targetX));
+        int ty = clampRow(cellOf(targetY));
+        if (!dirty && tx == targetCol && ty == targetRow) return false;
+        targetCol = tx;
+        targetRow = ty;
+        dirty = false;
+        computeDistances();
+        computeWaypoints();
+        return true;
+    }
+
+    // Within one cell of the target, where the field is too coarse to follow.
+    bool nearTarget(float x, float y) const {
+        return abs(clampCol(cellOf(x)) - targetCol) <= 1 && abs(clampRow(cellOf(y)) - targetRow) <= 1;
+    }
+
+    // Where to head next from (x, y). Unreachable cells return their own
+    // centre, so whatever is in them stays put.
+    const Vec2& waypoint(float x, float y) const {
+        return waypoints[index(clampCol(cellOf(x)), clampRow(cellOf(y)))];
+    }
+
+private:
+    static const int STRAIGHT_COST = 10;
+    static const int DIAGONAL_COST = 14;
+
+    struct Neighbour {
+        int offset;
+        int dx, dy;
+        int cost;
+    };
+
+    int cellSize;
+    int cols, rows;
+    int stride;
+    vector<unsigned char> blocked;
+    vector<int> distance;
+    vector<Vec2> waypoints;
+    Neighbour neighbours[8];
+    vector<int> buckets[DIAGONAL_COST + 1];  // cells by distance, modulo the largest step
+    int targetCol = -1, targetRow = -1;
+    bool dirty = true;
+
+    int index(int cx, int cy) const {
+        return (cy + 1) * stride + cx + 1;
+    }
+
+    // Diagonal steps need both orthogonal neighbours open.
+    bool canStep(int cell, const Neighbour& n) const {
+        if (blocked[cell + n.offset]) return false;
+        return n.cost == STRAIGHT_COST || (!blocked[cell + n.dx] && !blocked[cell + n.dy * stride]);
+    }
+
+    void computeDistances() {
+        fill(distance.begin(), distance.end(), INT_MAX);
+        int start = index(targetCol, targetRow);
+        distance[start] = 0;
+        buckets[0].push_back(start);
+        int pending = 1;
+
+        for (int d = 0; pending > 0; d++) {
+            vector<int>& bucket = buckets[d % (DIAGONAL_COST + 1)];
+            // Relaxations from this bucket land in later buckets, never this one.
+            for (size_t i = 0; i < bucket.size(); i++) {
+                int cell = bucket[i];
+                if (distance[cell] != d) continue;
+                for (const Neighbour& n : neighbours) {
+                    int next = cell + n.offset;
+                    int nd = d + n.cost;
+                    if (nd < distance[next] && canStep(cell, n)) {
+                        distance[next] = nd;
+                        buckets[nd % (DIAGONAL_COST + 1)].push_back(next);
+                        pending++;
+                    }
+                }
+            }
+            pending -= (int)bucket.size();
+            bucket.clear();
+        }
+    }
+
+    void computeWaypoints() {
+        for (int cy = 0; cy < rows; cy++) {
+            for (int cx = 0; cx < cols; cx++) {
+                int cell = index(cx, cy);
+                int bestX = cx, bestY = cy;
+                int best = distance[cell];
+                for (const Neighbour& n : neighbours) {
+                    int d = distance[cell + n.offset];
+                    if (d < best && canStep(cell, n)) {
+                        best = d;
+                        bestX = cx + n.dx;
+                        bestY = cy + n.dy;
+                    }
+                }
+                waypoints[cell] = {(bestX + 0.5f) * cellSize, (bestY + 0.5f) * cellSize};
+            }
+        }
+    }
+
+    int cellOf(float v) const {
+        return (int)floor(v / cellSize);
+    }
+
+    int clampCol(int c) const { return c < 0 ? 0 : (c >= cols ? cols - 1 : c); }
+    int clampRow(int r) const { return r < 0 ? 0 : (r >= rows ? rows - 1 : r); }
+};
+
+#endif
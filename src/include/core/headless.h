@@ -0,0 +1,17 @@
+#ifndef CORE_HEADLESS_H
+#define CORE_HEADLESS_H
+
+#include <string>
+#include "core/simulation.h"
+
+// Runs the simulation for the given number of ticks of 1/tickRate seconds as
+// fast as possible, driven by a scripted bot, and prints throughput and entity counts.
+// The bot starts every run in the given mode.
+void runHeadless(Simulation& sim, int ticks, int tickRate = DEFAULT_TICK_RATE, GameMode mode = MODE_WAVES);
+
+// Feeds a recorded input log (see core/replay.h) through a Simulation seeded
+// from it, at the recorded fixed step and as fast as possible, and prints the
+// same report. Returns false if the log cannot be read.
+bool runReplay(const std::string& path);
+
+#endif
@@ -0,0 +1,71 @@
+#ifndef CORE_JOB_SYSTEM_H
+#define CORE_JOB_SYSTEM_H
+
+#include <cstddef>
+#include <vector>
+#include <deque>
+#include <memory>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <type_traits>
+
+using namespace std;
+
+// Work-stealing scheduler for data-parallel loops. Each thread owns a deque
+// of range jobs: it pops its own from the back and steals from the front of
+// the others when it runs dry. The thread calling parallelFor() is thread 0
+// and works too, so JobSystem(1) starts no threads and runs everything inline.
+//
+// parallelFor() only splits the range; bodies that write disjoint elements
+// give the same result whatever the thread count or the order chunks ran in.
+class JobSystem {
+public:
+    explicit JobSystem(int threads);
+    ~JobSystem();
+
+    int threadCount() const { return (int)queues.size(); }
+
+    // Runs body(begin, end) over [0, count) in chunks of at least grain items
+    // and returns once all of them have finished. Call from one thread only.
+    template <typename Body>
+    void parallelFor(size_t count, size_t grain, Body&& body) {
+        if (count == 0) return;
+        if (threadCount() == 1 || count <= grain) {
+            body((size_t)0, count);
+            return;
+        }
+        typedef typename remove_reference<Body>::type BodyType;
+        run(count, grain, [](void* context, size_t begin, size_t end) {
+            (*static_cast<BodyType*>(context))(begin, end);
+        }, (void*)&body);
+    }
+
+private:
+    typedef void (*RangeFunction)(void* context, size_t begin, size_t end);
+
+    struct Job {
+        RangeFunction function;
+        void* context;
+        size_t begin, end;
+    };
+
+    struct Queue {
+        mutex lock;
+        deque<Job> jobs;
+    };
+
+    vector<unique_ptr<Queue>> queues;
+    vector<thread> workers;
+    atomic<int> pending{0};
+    atomic<bool> stopping{false};
+    mutex sleepLock;
+    condition_variable wake;
+
+    void run(size_t count, size_t grain, RangeFunction function, void* context);
+    bool runOne(int self);
+    void workerLoop(int self);
+};
+
+#endif
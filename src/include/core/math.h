@@ -0,0 +1,33 @@
+#ifndef CORE_MATH_H
+#define CORE_MATH_H
+
+// Plain geometry types for the simulation, so it does not depend on SDL.
+// Positions are in pixels; floats so movement can be scaled by the tick length.
+
+struct Vec2 {
+    float x, y;
+};
+
+struct Rect {
+    float x, y, w, h;
+};
+
+// Same semantics as SDL_HasIntersection: touching edges and empty rects do not count.
+inline bool intersects(const Rect& a, const Rect& b) {
+    if (a.w <= 0 || a.h <= 0 || b.w <= 0 || b.h <= 0) return false;
+    return a.x < b.x + b.w && b.x < a.x + a.w &&
+           a.y < b.y + b.h && b.y < a.y + a.h;
+}
+
+inline void keepInside(Rect& rect, float width, float height) {
+    if (rect.x < 0) rect.x = 0;
+    if (rect.y < 0) rect.y = 0;
+    if (rect.x + rect.w > width) rect.x = width - rect.w;
+    if (rect.y + rect.h > height) rect.y = height - rect.h;
+}
+
+inline float lerp(float a, float b, float t) {
+    return a + (b - a) * t;
+}
+
+#endif
@@ -0,0 +1,63 @@
+#ifndef CORE_POOL_H
+#define CORE_POOL_H
+
+#include <vector>
+
+using namespace std;
+
+// Fixed-capacity object pool. All storage is allocated up front; spawn() pops
+// a slot off the free list and despawn() pushes it back, both in O(1).
+// Iterate live objects with: for (int i = 0; i < pool.end(); i++) if (pool.isAlive(i)) ...
+template <typename T>
+class Pool {
+public:
+    explicit Pool(int capacity)
+        : slots(capacity), alive(capacity, false), freeList(capacity), highWater(0), count(0) {
+        clear();
+    }
+
+    // Returns nullptr when the pool is full.
+    T* spawn() {
+        if (freeList.empty()) return nullptr;
+        int i = freeList.back();
+        freeList.pop_back();
+        alive[i] = true;
+        count++;
+        if (i >= highWater) highWater = i + 1;
+        return &slots[i];
+    }
+
+    void despawn(int i) {
+        if (!alive[i]) return;
+        alive[i] = false;
+        freeList.push_back(i);
+        count--;
+        while (highWater > 0 && !alive[highWater - 1]) highWater--;
+    }
+
+    void clear() {
+        int capacity = (int)slots.size();
+        freeList.clear();
+        for (int i = capacity - 1; i >= 0; i--) freeList.push_back(i);
+        alive.assign(capacity, false);
+        highWater = 0;
+        count = 0;
+    }
+
+    bool isAlive(int i) const { return alive[i]; }
+    int end() const { return highWater; }
+    int size() const { return count; }
+    int capacity() const { return (int)slots.size(); }
+
+    T& operator[](int i) { return slots[i]; }
+    const T& operator[](int i) const { return slots[i]; }
+
+private:
+    vector<T> slots;
+    vector<bool> alive;
+    vector<int> freeList;
+    int highWater;
+    int count;
+};
+
+#endif
@@ -0,0 +1,127 @@
+#ifndef CORE_PROFILER_H
+#define CORE_PROFILER_H
+
+#include <cstdint>
+#include <vector>
+#include <string>
+#include <thread>
+#include <mutex>
+
+using namespace std;
+
+struct ProfileZoneStats {
+    const char* name;
+    double minMs, avgMs, p99Ms;  // per frame, over the recorded history
+    int calls;                   // in the last frame
+};
+
+// Scoped zone timer. Time spent in each zone is summed over a frame and
+// endFrame() pushes the totals into a per-zone ring buffer of the last
+// HISTORY_FRAMES frames. The clock defaults to std::chrono::steady_clock;
+// the SDL front end swaps in SDL_GetPerformanceCounter.
+// Zones may be recorded from any thread (under a lock); time from threads
+// other than the one calling endFrame() counts towards whichever frame is
+// open when it is recorded. Trace events keep the recording thread's id.
+//
+// While a trace is running every zone is also recorded as a Chrome Trace
+// Event into a preallocated buffer (events past its capacity are dropped).
+// writeTrace() hands the buffer to a background thread that writes the JSON,
+// and capture continues into a second buffer of the same size.
+class Profiler {
+public:
+    static const int HISTORY_FRAMES = 256;
+    typedef uint64_t (*ClockFunction)();
+
+    static const size_t DEFAULT_TRACE_CAPACITY = 1 << 20;
+
+    Profiler();
+    ~Profiler();
+
+    void setClock(ClockFunction now, uint64_t ticksPerSecond);
+    uint64_t now() const { return clock(); }
+
+    // Returns the id of the zone called name, registering it on first use.
+    int zone(const char* name);
+
+    void record(int zone, uint64_t start, uint64_t end) {
+        lock_guard<mutex> hold(lock);
+        Zone& z = zones[zone];
+        z.frameTicks += end - start;
+        z.frameCalls++;
+        if (tracing) {
+            if (trace.size() < trace.capacity()) trace.push_back({z.name, start, end - start, threadId()});
+            else droppedEvents++;
+        }
+    }
+
+    void endFrame();
+
+    // Zones that ran at least once, in registration order.
+    vector<ProfileZoneStats> stats() const;
+
+    void startTrace(size_t capacity = DEFAULT_TRACE_CAPACITY);
+    bool isTracing() const { return tracing; }
+    // Writes the events captured so far to path off the calling thread.
+    void writeTrace(const string& path);
+    // Blocks until pending trace writes are on disk.
+    void finishTraceWrites();
+
+private:
+    struct TraceEvent {
+        const char* name;
+        uint64_t start;
+        uint64_t duration;
+        int thread;
+    };
+
+    struct Zone {
+        const char* name;
+        uint64_t frameTicks = 0;
+        int frameCalls = 0;
+        int lastCalls = 0;
+        vector<uint64_t> history;
+        int head = 0;
+        int count = 0;
+    };
+
+    mutable mutex lock;
+    ClockFunction clock;
+    uint64_t ticksPerSecond;
+    vector<Zone> zones;
+
+    bool tracing = false;
+    uint64_t traceStart = 0;
+    size_t droppedEvents = 0;
+    vector<TraceEvent> trace;
+    vector<TraceEvent> spareTrace;
+    thread traceWriter;
+
+    // Small per-thread ids in first-recorded order, for the trace's tid.
+    static int threadId();
+};
+
+Profiler& profiler();
+
+class ProfileScope {
+public:
+    explicit ProfileScope(int zone) : zone(zone), start(profiler().now()) {}
+    ~ProfileScope() { profiler().record(zone, start, profiler().now()); }
+
+private:
+    int zone;
+    uint64_t start;
+};
+
+#define PROFILE_CONCAT_INNER(a, b) a##b
+#define PROFILE_CONCAT(a, b) PROFILE_CONCAT_INNER(a, b)
+
+// PROFILE_ZONE("name") times the rest of the enclosing scope.
+#ifdef PROFILER_DISABLED
+#define PROFILE_ZONE(name)
+#else
+#define PROFILE_ZONE(name) \
+    static const int PROFILE_CONCAT(profileZone, __LINE__) = profiler().zone(name); \
+    ProfileScope PROFILE_CONCAT(profileScope, __LINE__)(PROFILE_CONCAT(profileZone, __LINE__))
+#endif
+
+#endif
@@ -0,0 +1,47 @@
+#ifndef CORE_RANDOM_H
+#define CORE_RANDOM_H
+
+#include <cstdint>
+
+// PCG32 (XSH-RR): 64-bit state, 32-bit output. Generators built from the
+// same seed but different stream ids produce independent sequences, so each
+// subsystem can own one and draw from it on any thread without touching the
+// others.
+class Random {
+public:
+    Random(uint64_t seed = 0, uint64_t stream = 0) {
+        reseed(seed, stream);
+    }
+
+    void reseed(uint64_t seed, uint64_t stream) {
+        state = 0;
+        increment = (stream << 1) | 1;
+        next();
+        state += seed;
+        next();
+    }
+
+    uint32_t next() {
+        uint64_t old = state;
+        state = old * 6364136223846793005ULL + increment;
+        uint32_t xorshifted = (uint32_t)(((old >> 18) ^ old) >> 27);
+        uint32_t rot = (uint32_t)(old >> 59);
+        return (xorshifted >> rot) | (xorshifted << ((32 - rot) & 31));
+    }
+
+    // Uniform in [0, bound), bound > 0. Multiply-shift, no division.
+    uint32_t below(uint32_t bound) {
+        return (uint32_t)(((uint64_t)next() * bound) >> 32);
+    }
+
+    // Uniform in [0, 1).
+    float nextFloat() {
+        return (next() >> 8) * (1.0f / 16777216.0f);
+    }
+
+private:
+    uint64_t state;
+    uint64_t increment;
+};
+
+#endif
@@ -0,0 +1,54 @@
+#ifndef CORE_REPLAY_H
+#define CORE_REPLAY_H
+
+#include <cstdint>
+#include <string>
+#include <fstream>
+#include "core/simulation.h"
+
+using namespace std;
+
+// Binary input log: a header with the seed and tick rate, then one entry per
+// menu command or simulation tick, in the order they reached the Simulation.
+//
+//   header:  "DSRP" u32 version, u64 seed, u32 tick rate
+//   command: one byte < 0x80, the SimCommand
+//   tick:    one byte 0x80 | flags (up, down, left, right, fire, aim moved);
+//            followed by i16 aimX, i16 aimY only when the aim moved
+//
+// A tick with unchanged aim is a single byte.
+struct ReplayEntry {
+    enum Kind { COMMAND, TICK } kind;
+    SimCommand command;
+    SimInput input;
+};
+
+class ReplayWriter {
+public:
+    bool open(const string& path, uint64_t seed, int tickRate);
+    bool isOpen() const { return file.is_open(); }
+    void command(SimCommand command);
+    void tick(const SimInput& input);
+    void close();
+
+private:
+    ofstream file;
+    int16_t aimX = 0, aimY = 0;
+    int ticks = 0;
+};
+
+class ReplayReader {
+public:
+    bool open(const string& path);
+    // False at the end of the log or on a truncated entry.
+    bool next(ReplayEntry& entry);
+
+    uint64_t seed = 0;
+    int tickRate = DEFAULT_TICK_RATE;
+
+private:
+    ifstream file;
+    SimInput last;
+};
+
+#endif
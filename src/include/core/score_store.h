@@ -0,0 +1,69 @@
+#ifndef CORE_SCORE_STORE_H
+#define CORE_SCORE_STORE_H
+
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <deque>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+
+using namespace std;
+
+struct RunRecord {
+    int32_t score;
+    int32_t wave;
+    int32_t weapon;
+    uint32_t durationMs;
+};
+
+// High score and run history, loaded once and kept in memory. Writes go to a
+// background thread: each run is appended to a compact binary log, and the
+// high score file is replaced atomically (write to a temp file, then rename).
+// The best runs are kept sorted in memory so topRuns() never rescans the log.
+class ScoreStore {
+public:
+    static const int TOP_RUNS_KEPT = 100;
+
+    ScoreStore(const string& highScorePath, const string& runLogPath);
+    ~ScoreStore();
+
+    // Reads the high score file and the run log. Call once at startup.
+    void load();
+
+    int highScore() const { return best; }
+
+    // Best runs first, at most n (and at most TOP_RUNS_KEPT).
+    vector<RunRecord> topRuns(int n) const;
+
+    // Updates the in-memory state immediately and queues the writes.
+    void recordRun(const RunRecord& run);
+
+    // Waits for queued writes and stops the writer thread.
+    void close();
+
+private:
+    struct WriteJob {
+        RunRecord run;
+        bool newHighScore;
+    };
+
+    string highScorePath;
+    string runLogPath;
+    int best;
+    vector<RunRecord> top;
+
+    thread writer;
+    mutex queueMutex;
+    condition_variable queueChanged;
+    deque<WriteJob> queue;
+    bool stopping;
+
+    void addToTop(const RunRecord& run);
+    void writeLoop();
+    void appendRun(const RunRecord& run);
+    void replaceHighScore(int score);
+};
+
+#endif
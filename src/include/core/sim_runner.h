@@ -0,0 +1,80 @@
+#ifndef CORE_SIM_RUNNER_H
+#define CORE_SIM_RUNNER_H
+
+#include <cstdint>
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include "core/simulation.h"
+#include "core/snapshot.h"
+#include "core/triple_buffer.h"
+#include "core/replay.h"
+#include "core/steering_budget.h"
+
+using namespace std;
+
+// Runs a Simulation on its own thread at a fixed tick rate, so rendering and
+// simulation overlap instead of taking turns. After each batch of ticks (and
+// after menu commands) it publishes a Snapshot through a TripleBuffer; the
+// render thread only ever reads snapshots, never the Simulation.
+//
+// Input and commands travel the other way under a mutex. Commands are applied
+// in order between ticks. Outside PLAYING the thread sleeps until a command
+// arrives. When given a ReplayWriter the runner does the recording, since only
+// it knows which tick each command landed before.
+//
+// Steering times feed a SteeringBudget of STEERING_BUDGET_TICK_FRACTION of a
+// tick; its slice changes go to the Simulation as commands, so they are
+// recorded and replay identically.
+class SimulationRunner {
+public:
+    SimulationRunner(Simulation& sim, int tickRate, ReplayWriter* recorder = nullptr);
+    ~SimulationRunner();
+
+    void start();
+    void stop();
+
+    // Called from the render thread.
+    void setInput(const SimInput& input);
+    void command(SimCommand command);
+    // Commands queued but not yet reflected in snapshot, which should be the one
+    // latest() last returned (calling latest() again would invalidate it).
+    bool commandsPending(const Snapshot& snapshot) const { return snapshot.commandsApplied < commandsSent; }
+    // The newest published snapshot; stays valid until the next call.
+    const Snapshot& latest() {
+        snapshots.read();
+        return snapshots.front();
+    }
+
+    double tickMs() const { return tickSeconds * 1000.0; }
+
+    // Monotonic nanoseconds; the clock Snapshot::tickTimeNs is on.
+    static int64_t clockNs();
+
+private:
+    Simulation& sim;
+    double tickSeconds;
+    ReplayWriter* recorder;
+    TripleBuffer<Snapshot> snapshots;
+    thread worker;
+
+    mutex inputLock;
+    condition_variable wake;
+    SimInput input;
+    vector<SimCommand> commands;
+    bool stopping = false;
+    uint64_t commandsSent = 0;  // render thread only
+
+    // Simulation thread only.
+    uint64_t ticks = 0;
+    uint64_t commandsApplied = 0;
+    SteeringBudget steeringBudget;
+    uint64_t enemyHits = 0, pickups = 0, runsEnded = 0;
+    RunRecord lastRun = {};
+
+    void run();
+    void publish(int64_t tickTimeNs);
+};
+
+#endif
@@ -0,0 +1,15 @@
+#ifndef CORE_SIMD_H
+#define CORE_SIMD_H
+
+// Which vector instruction set the simulation kernels (steering, AABB
+// batches) use. Defaults to the best the CPU supports according to the
+// compiler's CPU detection; paths the build or CPU lacks fall back.
+enum SimdPath { SIMD_SCALAR, SIMD_SSE2, SIMD_AVX2 };
+
+SimdPath detectSimdPath();
+// Lets the caller pick, e.g. from SDL_HasAVX2.
+void setSimdPath(SimdPath path);
+SimdPath simdPath();
+const char* simdPathName(SimdPath path);
+
+#endif
@@ -0,0 +1,219 @@
+#ifndef CORE_SIMULATION_H
+#define CORE_SIMULATION_H
+
+#include <vector>
+#include <cstdint>
+#include "constant.h"
+#include "core/math.h"
+#include "core/enemy_store.h"
+#include "core/pool.h"
+#include "core/spatial_grid.h"
+#include "core/flow_field.h"
+#include "core/random.h"
+#include "core/spawn_sampler.h"
+#include "core/job_system.h"
+
+using namespace std;
+
+struct Player {
+    Rect rect;
+    Vec2 prev;
+    float speed;
+};
+
+struct Coin {
+    Rect rect;
+};
+
+struct EnemyStats {
+    int health;
+    int speed;
+    int size;
+};
+
+const EnemyStats ENEMY_BASIC  = { 10,  2, 30 };
+const EnemyStats ENEMY_FAST   = {  5,  4, 30 };
+const EnemyStats ENEMY_TANK   = { 30,  2, 40 };
+
+struct Bullet {
+    Rect rect;
+    Vec2 prev;
+    float dx, dy;
+    float speed;
+    enum BulletType { PISTOL, SHOTGUN } type;
+};
+
+struct PowerUp {
+    Rect rect;
+    enum Type {HEALTH, SPEED} type;
+};
+
+// Per-tick player input, already translated from whatever device produced it.
+struct SimInput {
+    bool up = false, down = false, left = false, right = false;
+    float aimX = 0, aimY = 0;
+    bool fire = false;
+};
+
+// What happened during the last step(), for the presentation layer to react to
+// (sounds, high-score saving). Cleared at the start of every step.
+struct SimEvents {
+    int enemyHits = 0;
+    int pickups = 0;
+    bool playerDied = false;
+};
+
+struct CollisionStats {
+    int narrowPhaseTests = 0;
+    int bruteForceTests = 0;
+};
+
+enum GameState { TITLE_SCREEN, WEAPON_SELECTION, PLAYING, SHOP, UPGRADE_MENU, GAME_OVER };
+enum WeaponType { PISTOL, SHOTGUN };
+// Horde: no waves or menus, HORDE_ENEMIES enemies topped up as they die, a ring
+// of HORDE_BULLETS bullets kept in the air and no contact damage.
+enum GameMode { MODE_WAVES, MODE_HORDE };
+
+// Menu commands as data, so they can be recorded and replayed alongside SimInput.
+// The CMD_STEER_SLICES_* ones come from the steering budget, not the player.
+enum SimCommand : uint8_t {
+    CMD_START_GAME, CMD_SELECT_PISTOL, CMD_SELECT_SHOTGUN, CMD_BUY_HEALTH, CMD_BUY_DAMAGE,
+    CMD_LEAVE_SHOP, CMD_UPGRADE_SPEED, CMD_UPGRADE_DAMAGE, CMD_UPGRADE_HEALTH, CMD_RETURN_TO_TITLE,
+    CMD_START_HORDE, CMD_STEER_SLICES_1, CMD_STEER_SLICES_2, CMD_STEER_SLICES_4, CMD_STEER_SLICES_8,
+    CMD_ABANDON_RUN, SIM_COMMAND_COUNT
+};
+
+const int MAX_STEERING_SLICES = 8;
+
+// The command that sets the given slice count (a power of two up to MAX_STEERING_SLICES).
+inline SimCommand steeringSlicesCommand(int slices) {
+    if (slices >= 8) return CMD_STEER_SLICES_8;
+    if (slices >= 4) return CMD_STEER_SLICES_4;
+    if (slices >= 2) return CMD_STEER_SLICES_2;
+    return CMD_STEER_SLICES_1;
+}
+
+// The whole game rules: waves, enemies, bullets, pickups, scoring and the menu
+// state machine. Has no SDL dependency; time only advances through step().
+// Speeds are in pixels per SIM_REFERENCE_TICK_MS and scaled by the step length,
+// so the game plays the same at any tick rate.
+class Simulation {
+public:
+    GameState gameState = TITLE_SCREEN;
+    WeaponType selectedWeapon = PISTOL;
+    GameMode mode = MODE_WAVES;
+
+    Player player;
+    EnemyStore enemies;
+    Pool<Bullet> bullets;
+    vector<Coin> coinsOnGround;
+    vector<PowerUp> powerUps;
+
+    int wave;
+    int playerSpeed;
+    int playerHealth;
+    int playerDamage;
+    int score;
+    int coins;
+
+    SimEvents events;
+    CollisionStats stats;
+
+    // Everything random comes from seed, so equal seeds and inputs replay the same game.
+    explicit Simulation(uint64_t seed);
+
+    // Advances the game by dtMs milliseconds. Only does anything while PLAYING.
+    // Positions from before the step are kept for render interpolation.
+    void step(const SimInput& input, double dtMs);
+
+    // Menu commands, each a no-op outside the state it belongs to.
+    void startGame();
+    void startHorde();
+    void selectWeapon(WeaponType weapon);
+    void buyHealth();
+    void buyDamage();
+    void leaveShop();
+    void chooseUpgrade(int choice);
+    void returnToTitle();
+    // Ends the run in progress without a game over, e.g. to leave horde mode.
+    void abandonRun();
+    void apply(SimCommand command);
+
+    double time() const { return timeMs; }
+    uint64_t seed() const { return rngSeed; }
+
+    // Runs the data-parallel parts of step() on jobs; nullptr (the default)
+    // runs them inline. Results are identical either way.
+    void setJobSystem(JobSystem* jobSystem) { jobs = jobSystem; }
+    // Enemy headings are refreshed for 1/slices of the enemies per tick, round
+    // robin; the rest keep their last step. Enemies within a flow-field cell of
+    // the player are refreshed every tick. 1 (the default) refreshes all.
+    void setSteeringSlices(int slices);
+    int steeringSlices() const { return slices; }
+    // Wall time the last step spent steering. Timing only; nothing in the
+    // simulation reads it, so replays stay deterministic.
+    double lastSteeringMs() const { return steeringMs; }
+    // Sim time since the weapon was picked for the current run.
+    double runDuration() const { return timeMs - runStartMs; }
+
+private:
+    double timeMs;
+    double lastFireTime;
+    double runStartMs;
+    const double fireCooldown = 300;
+    float pendingDamage;
+    // The current wave's enemy types; those from spawnHead on are still to
+    // spawn, at queuedLevel, paced by spawnAllowance.
+    vector<EnemyType> spawnQueue;
+    size_t spawnHead = 0;
+    int queuedLevel = 1;
+    float spawnAllowance = 0;
+    JobSystem* jobs = nullptr;
+    int slices = 1;
+    uint32_t steerTick = 0;
+    double steeringMs = 0;
+
+    // One stream per subsystem: enemy positions, wave composition, power-up drops.
+    enum RandomStream { SPAWN_STREAM = 1, WAVE_STREAM, DROP_STREAM };
+    uint32_t hordeShots = 0;
+    uint64_t rngSeed;
+    Random spawnRandom;
+    Random waveRandom;
+    Random dropRandom;
+    SpawnSampler spawnSampler;
+
+    SpatialGrid enemyGrid;
+    FlowField flowField;
+    vector<bool> enemyDead;
+    vector<float> steerTargetX;
+    vector<float> steerTargetY;
+    vector<float> steerX, steerY, steerSpeed, steerVX, steerVY;
+    vector<uint32_t> steerIndex;
+    vector<int> pickedUp;
+    vector<uint64_t> hitBits;
+    vector<char> bulletGone;
+    vector<int> bulletTarget;
+
+    Vec2 randomSafeSpawn(Random& random);
+    void shootBullet(float aimX, float aimY);
+    void spawnEnemy(EnemyType type, int level);
+    void spawnWave();
+    void spawnQueued(float move);
+    void fillHorde();
+    void resetGame();
+    // Lowest-index enemy overlapping r, skipping those marked in dead.
+    // Thread-safe; adds the number of narrow-phase tests to tests.
+    int firstEnemyHit(const Rect& r, const vector<bool>* dead, int& tests) const;
+    // Batched player contact tests; the result is left in hitBits.
+    void playerHits(const float* x, const float* y, const float* w, const float* h, size_t count);
+    void playerHits(const Rect* first, size_t stride, size_t count);
+    Rect enemyRect(size_t i) const;
+
+    template <typename Body>
+    void parallelFor(size_t count, size_t grain, Body&& body) {
+        if (jobs) jobs->parallelFor(count, grain, body);
+        else if (count > 0) body((size_t)0, count);
+    }
+};
+
+#endif
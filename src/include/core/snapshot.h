@@ -0,0 +1,52 @@
+#ifndef CORE_SNAPSHOT_H
+#define CORE_SNAPSHOT_H
+
+#include <cstdint>
+#include <vector>
+#include "core/math.h"
+#include "core/simulation.h"
+#include "core/score_store.h"
+
+using namespace std;
+
+enum SpriteId : uint8_t { SPRITE_COIN, SPRITE_ENEMY, SPRITE_BULLET, SPRITE_POWERUP, SPRITE_PLAYER };
+
+struct SpriteInstance {
+    Rect rect;
+    Vec2 prev;  // position one tick earlier, for interpolation
+    SpriteId sprite;
+};
+
+struct HudValues {
+    int health = 0;
+    int wave = 0;
+    int score = 0;
+    int coins = 0;
+    int enemies = 0, bullets = 0, coinsOnGround = 0, powerUps = 0;
+    CollisionStats stats;
+};
+
+// Everything the presentation layer reads from the simulation after a tick,
+// copied out so it can be drawn while the next tick runs.
+//
+// Events are running totals rather than per-tick counts: a reader that skips
+// snapshots still sees every hit, pickup and finished run by comparing totals.
+struct Snapshot {
+    uint64_t ticks = 0;
+    int64_t tickTimeNs = 0;  // when the last tick was due, on SimulationRunner::clockNs()
+    GameState gameState = TITLE_SCREEN;
+    WeaponType selectedWeapon = PISTOL;
+    HudValues hud;
+    vector<SpriteInstance> sprites;  // in draw order
+
+    uint64_t enemyHits = 0;
+    uint64_t pickups = 0;
+    uint64_t runsEnded = 0;
+    RunRecord lastRun = {};
+    uint64_t commandsApplied = 0;
+};
+
+// Overwrites the simulation-derived parts of out: state, HUD and sprites.
+void captureSnapshot(const Simulation& sim, Snapshot& out);
+
+#endif
@@ -0,0 +1,88 @@
+#ifndef CORE_SPATIAL_GRID_H
+#define CORE_SPATIAL_GRID_H
+
+#include <vector>
+#include <algorithm>
+#include <cmath>
+
+using namespace std;
+
+// Uniform grid broadphase. Rebuilt every tick: insert() every object, call
+// build(), then forEachCandidate() a rect to visit the ids of objects in
+// overlapping cells. It is const, so several threads can query at once;
+// objects that span several cells may be visited more than once.
+class SpatialGrid {
+public:
+    SpatialGrid(int cellSize, int width, int height)
+        : cellSize(cellSize),
+          cols((width + cellSize - 1) / cellSize),
+          rows((height + cellSize - 1) / cellSize),
+          cellStart(cols * rows + 1, 0) {}
+
+    void clear() {
+        entries.clear();
+    }
+
+    void insert(int id, float x, float y, float w, float h) {
+        int x0, y0, x1, y1;
+        cellRange(x, y, w, h, x0, y0, x1, y1);
+        for (int cy = y0; cy <= y1; cy++) {
+            for (int cx = x0; cx <= x1; cx++) {
+                entries.push_back({cy * cols + cx, id});
+            }
+        }
+    }
+
+    // Counting sort of the inserted entries by cell.
+    void build() {
+        fill(cellStart.begin(), cellStart.end(), 0);
+        for (const Entry& e : entries) cellStart[e.cell + 1]++;
+        for (size_t c = 1; c < cellStart.size(); c++) cellStart[c] += cellStart[c - 1];
+
+        items.resize(entries.size());
+        cursor.assign(cellStart.begin(), cellStart.end() - 1);
+        for (const Entry& e : entries) items[cursor[e.cell]++] = e.id;
+    }
+
+    template <typename Visit>
+    void forEachCandidate(float x, float y, float w, float h, Visit&& visit) const {
+        int x0, y0, x1, y1;
+        cellRange(x, y, w, h, x0, y0, x1, y1);
+        for (int cy = y0; cy <= y1; cy++) {
+            for (int cx = x0; cx <= x1; cx++) {
+                int cell = cy * cols + cx;
+                for (int i = cellStart[cell]; i < cellStart[cell + 1]; i++) visit(items[i]);
+            }
+        }
+    }
+
+private:
+    struct Entry {
+        int cell;
+        int id;
+    };
+
+    int cellSize;
+    int cols, rows;
+    vector<Entry> entries;
+    vector<int> cellStart;
+    vector<int> cursor;
+    vector<int> items;
+
+    // Objects outside the grid are clamped into the border cells.
+    void cellRange(float x, float y, float w, float h, int& x0, int& y0, int& x1, int& y1) const {
+        x0 = clampCol(cellOf(x));
+        y0 = clampRow(cellOf(y));
+        x1 = clampCol(cellOf(x + max(w, 0.0f)));
+        y1 = clampRow(cellOf(y + max(h, 0.0f)));
+    }
+
+    int cellOf(float v) const {
+        return (int)floor(v / cellSize);
+    }
+
+    int clampCol(int c) const { return c < 0 ? 0 : (c >= cols ? cols - 1 : c); }
+    int clampRow(int r) const { return r < 0 ? 0 : (r >= rows ? rows - 1 : r); }
+};
+
+#endif
@@ -0,0 +1,58 @@
+#ifndef CORE_SPAWN_SAMPLER_H
+#define CORE_SPAWN_SAMPLER_H
+
+#include <algorithm>
+#include "core/math.h"
+#include "core/random.h"
+
+using namespace std;
+
+// Uniform points in an area minus a square keep-out zone, in constant time.
+// The part of the area outside the square (clamped to the area) is cut into
+// four bands: left and right of it at full height, above and below it in
+// between. A band is picked with probability proportional to its area and
+// sampled uniformly, so every draw costs three random numbers however much
+// of the area the square covers.
+class SpawnSampler {
+public:
+    explicit SpawnSampler(const Rect& area) : area(area) {}
+
+    // A point outside the square of half-size radius around (cx, cy). If the
+    // square covers the whole area, the area corner farthest from (cx, cy).
+    Vec2 sample(Random& random, float cx, float cy, float radius) const {
+        float x0 = area.x, y0 = area.y;
+        float x1 = area.x + area.w, y1 = area.y + area.h;
+        float left = min(max(cx - radius, x0), x1);
+        float right = min(max(cx + radius, x0), x1);
+        float top = min(max(cy - radius, y0), y1);
+        float bottom = min(max(cy + radius, y0), y1);
+        const Rect bands[4] = {
+            {x0, y0, left - x0, area.h},
+            {right, y0, x1 - right, area.h},
+            {left, y0, right - left, top - y0},
+            {left, bottom, right - left, y1 - bottom},
+        };
+
+        float total = 0;
+        for (const Rect& band : bands) total += band.w * band.h;
+        if (total <= 0) return {cx - x0 > x1 - cx ? x0 : x1, cy - y0 > y1 - cy ? y0 : y1};
+
+        // Rounding can leave pick past the last band; it then keeps the last non-empty one.
+        float pick = random.nextFloat() * total;
+        int chosen = 0;
+        for (int i = 0; i < 4; i++) {
+            float bandArea = bands[i].w * bands[i].h;
+            if (bandArea <= 0) continue;
+            chosen = i;
+            if (pick < bandArea) break;
+            pick -= bandArea;
+        }
+        const Rect& band = bands[chosen];
+        return {band.x + random.nextFloat() * band.w, band.y + random.nextFloat() * band.h};
+    }
+
+private:
+    Rect area;
+};
+
+#endif
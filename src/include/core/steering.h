@@ -0,0 +1,27 @@
+#ifndef CORE_STEERING_H
+#define CORE_STEERING_H
+
+#include <cstddef>
+
+// Writes to (vx[i], vy[i]) the step of speed[i] * move pixels along the unit
+// vector from (x[i], y[i]) toward (targetX[i], targetY[i]); zero for enemies
+// already on their target. Adding it to the position is left to the caller,
+// which can keep reusing it while the heading is not refreshed. The step is
+// speed * move / sqrt(length squared): IEEE rounds sqrt and division exactly,
+// so every path gives the same bits on any CPU (rsqrt approximations differ
+// between vendors and would make replays machine-specific).
+typedef void (*SteeringKernel)(const float* x, const float* y, const float* targetX, const float* targetY,
+                               const float* speed, float move, float* vx, float* vy, size_t count);
+
+void steerScalar(const float* x, const float* y, const float* targetX, const float* targetY, const float* speed, float move,
+                 float* vx, float* vy, size_t count);
+void steerSSE2(const float* x, const float* y, const float* targetX, const float* targetY, const float* speed, float move,
+               float* vx, float* vy, size_t count);
+void steerAVX2(const float* x, const float* y, const float* targetX, const float* targetY, const float* speed, float move,
+               float* vx, float* vy, size_t count);
+
+// Runs the kernel for the current simdPath().
+void steer(const float* x, const float* y, const float* targetX, const float* targetY, const float* speed, float move,
+           float* vx, float* vy, size_t count);
+
+#endif
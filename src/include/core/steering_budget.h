@@ -0,0 +1,36 @@
+#ifndef CORE_STEERING_BUDGET_H
+#define CORE_STEERING_BUDGET_H
+
+#include "core/simulation.h"
+
+// Picks the Simulation's steering slice count from the measured time of the
+// steering zone alone (Simulation::lastSteeringMs), so the rest of the step
+// can't keep it pinned. Every SAMPLE_TICKS steps it compares the average
+// against the budget: over it, the count doubles; under half of it, the count
+// halves again. Halving at most doubles the steering time, so it lands back
+// under the budget rather than bouncing.
+class SteeringBudget {
+public:
+    static const int SAMPLE_TICKS = 30;
+
+    explicit SteeringBudget(double budgetMs) : budgetMs(budgetMs) {}
+
+    // Feeds one step's steering time; returns the slice count to use from now on.
+    int update(double steeringMs, int slices) {
+        totalMs += steeringMs;
+        if (++samples < SAMPLE_TICKS) return slices;
+        double averageMs = totalMs / samples;
+        totalMs = 0;
+        samples = 0;
+        if (averageMs > budgetMs && slices < MAX_STEERING_SLICES) return slices * 2;
+        if (averageMs < budgetMs / 2 && slices > 1) return slices / 2;
+        return slices;
+    }
+
+private:
+    double budgetMs;
+    double totalMs = 0;
+    int samples = 0;
+};
+
+#endif
@@ -0,0 +1,44 @@
+#ifndef CORE_TRIPLE_BUFFER_H
+#define CORE_TRIPLE_BUFFER_H
+
+#include <atomic>
+
+using namespace std;
+
+// Lock-free handoff of whole values from one writer thread to one reader
+// thread. The writer fills back() and publish() swaps it with the spare slot;
+// read() swaps the spare slot into front() if something newer was published.
+// Neither side ever waits: the reader always gets the latest published value
+// and any it was too slow to see are skipped.
+//
+// back() still holds whatever was published two swaps ago, so the writer has
+// to overwrite all of it (reusing its allocations is the point).
+template <typename T>
+class TripleBuffer {
+public:
+    T& back() { return slots[backIndex]; }
+
+    void publish() {
+        backIndex = spare.exchange(backIndex | FRESH, memory_order_acq_rel) & INDEX_MASK;
+    }
+
+    // Returns true if front() changed.
+    bool read() {
+        if (!(spare.load(memory_order_relaxed) & FRESH)) return false;
+        frontIndex = spare.exchange(frontIndex, memory_order_acq_rel) & INDEX_MASK;
+        return true;
+    }
+
+    const T& front() const { return slots[frontIndex]; }
+
+private:
+    static const int INDEX_MASK = 3;
+    static const int FRESH = 4;  // set while the spare slot holds an unread value
+
+    T slots[3];
+    int backIndex = 0;   // writer only
+    int frontIndex = 1;  // reader only
+    atomic<int> spare{2};
+};
+
+#endif
@@ -7,19 +7,27 @@
 #include <SDL2/SDL_image.h>
 #include <vector>
 #include <cstdlib>
+#include <cstdio>
 #include <ctime>
 #include <string>
 #include <cmath>
 #include <algorithm>
 #include <iostream>
-#include <fstream>
 #include "constant.h"
+#include "core/simulation.h"
+#include "core/sim_runner.h"
+#include "core/score_store.h"
+#include "core/profiler.h"
+#include "core/replay.h"
+#include "core/simd.h"
+#include "text_atlas.h"
+#include "sprite_atlas.h"
+#include "sprite_batch.h"
+#include "asset_loader.h"
 
 using namespace std;
 
-struct Entity {
-    SDL_Rect rect;
-    int speed;
+struct Animation {
     int frameWidth, frameHeight;
     int currentFrame = 0;
     int maxFrames;
@@ -27,144 +35,210 @@ struct Entity {
     Uint32 lastFrameTime = 0;
 };
 
-struct Coin {
-    SDL_Rect rect;
-};
-
-struct Enemy : public Entity {
-    int health;
-    enum EnemyType { BASIC, FAST, TANK } type;
-};
-
-struct EnemyStats {
-    int health;
-    int speed;
-    int size;
-};
-
-const EnemyStats ENEMY_BASIC  = { 10,  2, 30 };
-const EnemyStats ENEMY_FAST   = {  5,  4, 30 };
-const EnemyStats ENEMY_TANK   = { 30,  2, 40 };
-
-struct Bullet {
-    SDL_Rect rect;
-    double dx, dy;
-    double speed;
-    enum BulletType { PISTOL, SHOTGUN } type;
-};
-
-struct PowerUp : public Entity {
-    enum Type {HEALTH, SPEED} type;
-};
-
-class Wall {
-public:
-    static void keepInside(SDL_Rect &rect) {
-        if (rect.x < 0) rect.x = 0;
-        if (rect.y < 0) rect.y = 0;
-        if (rect.x + rect.w > SCREEN_WIDTH) rect.x = SCREEN_WIDTH - rect.w;
-        if (rect.y + rect.h > SCREEN_HEIGHT) rect.y = SCREEN_HEIGHT - rect.h;
-    }
+inline SDL_FRect toSDL(const Rect& r) {
+    return {r.x, r.y, r.w, r.h};
+}
+
+// Rect drawn at the interpolated position between the previous and current sim step.
+inline Rect interpolate(const Rect& r, const Vec2& prev, float alpha) {
+    return {lerp(prev.x, r.x, alpha), lerp(prev.y, r.y, alpha), r.w, r.h};
+}
+
+// Thread count for the simulation's job system; 0 picks one per hardware thread.
+inline int jobThreads(int requested) {
+    if (requested > 0) return requested;
+    return max(1, (int)thread::hardware_concurrency());
+}
+
+struct GameConfig {
+    int tickRate = DEFAULT_TICK_RATE;
+    bool vsync = true;
+    string tracePath;  // capture a trace from startup when set
+    uint64_t seed = 0;
+    string recordPath;  // input log for headless replay, when set
+    int threads = 0;    // simulation job threads; 0 = one per hardware thread
 };
 
+// SDL presentation of a Simulation: turns SDL events into SimInput and menu
+// commands, plays sounds for SimEvents and draws the simulation state. The
+// Simulation runs on its own thread (SimulationRunner); everything here reads
+// the latest Snapshot it published instead.
 class Game {
 public:
-    enum GameState { TITLE_SCREEN, WEAPON_SELECTION, PLAYING, SHOP, UPGRADE_MENU, GAME_OVER };
-    GameState gameState = TITLE_SCREEN;
-    enum WeaponType { PISTOL, SHOTGUN };
-    WeaponType selectedWeapon = PISTOL;
-    Game() : running(false), wave(1), playerSpeed(PLAYER_START_SPEED), playerHealth(PLAYER_START_HEALTH), playerDamage(PLAYER_START_DAMAGE), score(0), coins(0) {
-        player.rect = {SCREEN_WIDTH / 2, SCREEN_HEIGHT / 2, 40, 40};
-        player.speed = playerSpeed;
-        srand(static_cast<unsigned int>(time(nullptr)));
+    explicit Game(const GameConfig& config = GameConfig())
+        : scores(HIGH_SCORE_PATH, RUN_LOG_PATH), config(config), jobs(jobThreads(config.threads)), sim(config.seed),
+          runner(sim, config.tickRate, &recorder), running(false) {
+        sim.setJobSystem(&jobs);
     }
 
     bool init() {
+        initCounter = SDL_GetPerformanceCounter();
+        profiler().setClock(SDL_GetPerformanceCounter, SDL_GetPerformanceFrequency());
+        setSimdPath(SDL_HasAVX2() ? SIMD_AVX2 : SDL_HasSSE2() ? SIMD_SSE2 : SIMD_SCALAR);
+        if (!config.tracePath.empty()) profiler().startTrace();
+        if (!config.recordPath.empty() && !recorder.open(config.recordPath, config.seed, config.tickRate)) {
+            cout << "Cannot record input to " << config.recordPath << endl;
+        }
+        scores.load();
         if (SDL_Init(SDL_INIT_VIDEO | SDL_INIT_AUDIO) < 0) return false;
-        if (!(IMG_Init(IMG_INIT_PNG) & IMG_INIT_PNG)) return false;
+        // Decoders are initialised up front: their lazy init is not thread-safe.
+        if (!(IMG_Init(IMG_INIT_PNG | IMG_INIT_JPG) & IMG_INIT_PNG)) return false;
+        Mix_Init(MIX_INIT_MP3);
         if (TTF_Init() < 0) return false;
         window = SDL_CreateWindow("Dungeon Survival", SDL_WINDOWPOS_CENTERED, SDL_WINDOWPOS_CENTERED, SCREEN_WIDTH, SCREEN_HEIGHT, SDL_WINDOW_SHOWN);
-        renderer = SDL_CreateRenderer(window, -1, SDL_RENDERER_ACCELERATED);
-        font = TTF_OpenFont("assets/fonts/arial.ttf", 24);
+        Uint32 rendererFlags = SDL_RENDERER_ACCELERATED | (config.vsync ? SDL_RENDERER_PRESENTVSYNC : 0);
+        renderer = SDL_CreateRenderer(window, -1, rendererFlags);
+        if (!window || !renderer) return false;
+        // Without render target support menus are simply redrawn directly.
+        menuScene = SDL_CreateTexture(renderer, SDL_PIXELFORMAT_ARGB8888, SDL_TEXTUREACCESS_TARGET, SCREEN_WIDTH, SCREEN_HEIGHT);
         Mix_OpenAudio(22050, MIX_DEFAULT_FORMAT, 2, 4096);
-        backgroundMusic = Mix_LoadMUS("assets/sounds/background.mp3");
-        if (!backgroundMusic) {
-        cout << "Failed to load background music: " << Mix_GetError() << endl;
-        return false;
+
+        // Title screen assets first, so the first frame can be shown while the rest decodes.
+        titlebgImage = loader.add(AssetLoader::IMAGE, "assets/images/titlebackground.png");
+        startButtonImage = loader.add(AssetLoader::IMAGE, "assets/images/startbutton.png");
+        quitButtonImage = loader.add(AssetLoader::IMAGE, "assets/images/quit.png");
+        backgroundImage = loader.add(AssetLoader::IMAGE, "assets/images/background.jfif");
+        gameoverImage = loader.add(AssetLoader::IMAGE, "assets/images/gameover.jfif");
+        musicJob = loader.add(AssetLoader::MUSIC, "assets/sounds/background.mp3");
+        hitSoundJob = loader.add(AssetLoader::SOUND, "assets/sounds/hit.wav");
+        pickupSoundJob = loader.add(AssetLoader::SOUND, "assets/sounds/pickup.wav");
+        const char* sprites[][2] = {
+            {"bullet", "assets/images/bulletTexture.png"},
+            {"player", "assets/images/player.png"},
+            {"enemy", "assets/images/enemy.png"},
+            {"coin", "assets/images/coin.png"},
+            {"powerup", "assets/images/powerup.png"},
+            {"pistol", "assets/images/pistol.png"},
+            {"shotgun", "assets/images/shotgun.png"},
+            {"shophealth", "assets/images/shophealth.png"},
+            {"shopdamage", "assets/images/shopdamage.png"},
+            {"upgradespeed", "assets/images/upgradespeed.png"},
+            {"upgradedamage", "assets/images/upgradedamage.png"},
+            {"upgradehealth", "assets/images/upgradehealth.png"},
+        };
+        for (auto& sprite : sprites) {
+            spriteJobs.push_back({sprite[0], loader.add(AssetLoader::IMAGE, sprite[1])});
         }
-        hitSound = Mix_LoadWAV("assets/sounds/hit.wav");
-        pickupSound = Mix_LoadWAV("assets/sounds/pickup.wav");
-        titlebgTexture = loadTexture("assets/images/titlebackground.png");
-        startButtonTexture = loadTexture("assets/images/startbutton.png");
-        quitButtonTexture = loadTexture("assets/images/quit.png");
-        bulletTexture = loadTexture("assets/images/bulletTexture.png");
-        playerTexture = loadTexture("assets/images/player.png");
-        enemyTexture = loadTexture("assets/images/enemy.png");
-        coinTexture = loadTexture("assets/images/coin.png");
-        powerUpTexture = loadTexture("assets/images/powerup.png");
-        pistolTexture = loadTexture("assets/images/pistol.png");
-        shotgunTexture = loadTexture("assets/images/shotgun.png");
-        shopHealthTexture = loadTexture("assets/images/shophealth.png");
-        shopDamageTexture = loadTexture("assets/images/shopdamage.png");
-        upgradeSpeedTexture = loadTexture("assets/images/upgradespeed.png");
-        upgradeDamageTexture = loadTexture("assets/images/upgradedamage.png");
-        upgradeHealthTexture = loadTexture("assets/images/upgradehealth.png");
-        backgroundTexture = loadTexture("assets/images/background.jfif");
-        gameoverTexture = loadTexture("assets/images/gameover.jfif");
-
-    if (!playerTexture || !enemyTexture || !coinTexture || !powerUpTexture || !pistolTexture || !shotgunTexture || !shopHealthTexture || !shopDamageTexture || !upgradeSpeedTexture || !upgradeDamageTexture || !upgradeHealthTexture || !backgroundTexture) return false;
-        return window && renderer && font && hitSound && pickupSound;
-    }
-
-    SDL_Texture* loadTexture(const std::string& path) {
-        SDL_Surface* surface = IMG_Load(path.c_str());
-        if (!surface) {
-            cout << "Failed to load image: " << IMG_GetError() << endl;
-            return nullptr;
+        loader.start(max(2, (int)thread::hardware_concurrency()));
+
+        font = TTF_OpenFont("assets/fonts/arial.ttf", 24);
+        if (!font || !textAtlas.build(renderer, font)) return false;
+        batch.setRenderer(renderer);
+
+        if (!loader.wait(titlebgImage) || !loader.wait(startButtonImage) || !loader.wait(quitButtonImage)) return false;
+        titlebgTexture = SDL_CreateTextureFromSurface(renderer, loader.surface(titlebgImage));
+        startButtonTexture = SDL_CreateTextureFromSurface(renderer, loader.surface(startButtonImage));
+        quitButtonTexture = SDL_CreateTextureFromSurface(renderer, loader.surface(quitButtonImage));
+        return titlebgTexture && startButtonTexture && quitButtonTexture;
+    }
+
+    // Turns the rest of the decoded assets into textures and sounds once the
+    // loader is done. Only blocks if block is set; stops the game on failure.
+    void finishLoading(bool block) {
+        if (assetsLoaded || (!block && !loader.allDone())) return;
+        // On failure cleanup() frees whatever the loader did decode.
+        if (!loader.waitAll()) {
+            running = false;
+            return;
         }
-        SDL_Texture* texture = SDL_CreateTextureFromSurface(renderer, surface);
-        SDL_FreeSurface(surface);
-        return texture;
+        loader.join();
+        assetsLoaded = true;
+        backgroundMusic = loader.music(musicJob);
+        hitSound = loader.chunk(hitSoundJob);
+        pickupSound = loader.chunk(pickupSoundJob);
+
+        backgroundTexture = SDL_CreateTextureFromSurface(renderer, loader.surface(backgroundImage));
+        gameoverTexture = SDL_CreateTextureFromSurface(renderer, loader.surface(gameoverImage));
+
+        // Full-screen backgrounds stay separate; sprites are packed into one texture.
+        vector<SpriteSource> sources;
+        for (auto& job : spriteJobs) sources.push_back({job.first, loader.surface(job.second)});
+        if (!backgroundTexture || !spriteAtlas.build(renderer, sources)) {
+            running = false;
+            return;
+        }
+        bulletSprite = spriteAtlas.get("bullet");
+        playerSprite = spriteAtlas.get("player");
+        enemySprite = spriteAtlas.get("enemy");
+        coinSprite = spriteAtlas.get("coin");
+        powerUpSprite = spriteAtlas.get("powerup");
+        pistolSprite = spriteAtlas.get("pistol");
+        shotgunSprite = spriteAtlas.get("shotgun");
+        shopHealthSprite = spriteAtlas.get("shophealth");
+        shopDamageSprite = spriteAtlas.get("shopdamage");
+        upgradeSpeedSprite = spriteAtlas.get("upgradespeed");
+        upgradeDamageSprite = spriteAtlas.get("upgradedamage");
+        upgradeHealthSprite = spriteAtlas.get("upgradehealth");
+
+        Mix_PlayMusic(backgroundMusic, -1);
+        Mix_VolumeMusic(32);
+
+        cout << "All assets loaded after " << millisecondsSince(initCounter) << " ms" << endl;
+    }
+
+    static double millisecondsSince(Uint64 counter) {
+        return (SDL_GetPerformanceCounter() - counter) * 1000.0 / SDL_GetPerformanceFrequency();
     }
 
     void run() {
         running = true;
-        Mix_PlayMusic(backgroundMusic, -1);
-        Mix_VolumeMusic(32);
         setupPlayer();
+
+        // The simulation ticks at a fixed rate on its own thread; each frame
+        // draws the latest snapshot, interpolated by how far past its tick we are.
+        runner.start();
         while (running) {
+            profiler().endFrame();
+            PROFILE_ZONE("frame");
+            view = &runner.latest();
+
             handleEvents();
-            
-            if (gameState == TITLE_SCREEN) {
-                renderTitleScreen();
-            } else if (gameState == GAME_OVER) {
-                renderGameOver();
+            // Leaving the title screen needs everything else, so wait for it then.
+            finishLoading(view->gameState != TITLE_SCREEN);
+            if (!running) break;
+            playEvents();
+
+            if (view->gameState != PLAYING) {
+                // Menus are static: sleep until an event arrives. The timeout
+                // only keeps background loading polled. A command on its way to
+                // the simulation is waited for instead, so its result shows at once.
+                if (runner.commandsPending(*view)) {
+                    SDL_Delay(1);
+                } else {
+                    renderMenu();
+                    SDL_WaitEventTimeout(NULL, MENU_IDLE_WAIT_MS);
+                }
             } else {
-                update();
-                render();
+                double sinceTickMs = (SimulationRunner::clockNs() - view->tickTimeNs) / 1e6;
+                render((float)min(1.0, max(0.0, sinceTickMs / runner.tickMs())));
             }
-    
-            SDL_Delay(16);
         }
     }
 
     void cleanup() {
+        runner.stop();
+        if (profiler().isTracing()) profiler().writeTrace(nextTracePath());
+        profiler().finishTraceWrites();
+        recorder.close();
+        scores.close();
+        loader.join();
+        if (!assetsLoaded) {
+            backgroundMusic = loader.music(musicJob);
+            hitSound = loader.chunk(hitSoundJob);
+            pickupSound = loader.chunk(pickupSoundJob);
+        }
         Mix_FreeMusic(backgroundMusic);
-        SDL_DestroyTexture(bulletTexture);
-        SDL_DestroyTexture(playerTexture);
-        SDL_DestroyTexture(enemyTexture);
-        SDL_DestroyTexture(coinTexture);
-        SDL_DestroyTexture(powerUpTexture);
-        SDL_DestroyTexture(pistolTexture);
-        SDL_DestroyTexture(shotgunTexture);
-        SDL_DestroyTexture(shopHealthTexture);
-        SDL_DestroyTexture(shopDamageTexture);
-        SDL_DestroyTexture(upgradeSpeedTexture);
-        SDL_DestroyTexture(upgradeDamageTexture);
-        SDL_DestroyTexture(upgradeHealthTexture);
+        spriteAtlas.destroy();
+        SDL_DestroyTexture(titlebgTexture);
+        SDL_DestroyTexture(startButtonTexture);
+        SDL_DestroyTexture(quitButtonTexture);
+        SDL_DestroyTexture(backgroundTexture);
+        SDL_DestroyTexture(gameoverTexture);
+        if (menuScene) SDL_DestroyTexture(menuScene);
         IMG_Quit();
         Mix_FreeChunk(hitSound);
         Mix_FreeChunk(pickupSound);
+        textAtlas.destroy();
         TTF_CloseFont(font);
         SDL_DestroyRenderer(renderer);
         SDL_DestroyWindow(window);
@@ -174,485 +248,380 @@ public:
     }
 
 private:
-    SDL_Window* window;
-    SDL_Renderer* renderer;
-    TTF_Font* font;
-    Mix_Music* backgroundMusic;
-    Mix_Chunk* hitSound;
-    Mix_Chunk* pickupSound;
-    SDL_Texture* titlebgTexture;
-    SDL_Texture* startButtonTexture;
-    SDL_Texture* quitButtonTexture;
-    SDL_Texture* bulletTexture;
-    SDL_Texture* playerTexture;
-    SDL_Texture* enemyTexture;
-    SDL_Texture* coinTexture;
-    SDL_Texture* powerUpTexture;
-    SDL_Texture* pistolTexture;
-    SDL_Texture* shotgunTexture;
-    SDL_Texture* shopHealthTexture;
-    SDL_Texture* shopDamageTexture;
-    SDL_Texture* upgradeSpeedTexture;
-    SDL_Texture* upgradeDamageTexture;
-    SDL_Texture* upgradeHealthTexture;
-    SDL_Texture* backgroundTexture;
-    SDL_Texture* gameoverTexture;
-    Entity player;
-    vector<Enemy> enemies;
-    vector<Coin> coinsOnGround;
-    vector<PowerUp> powerUps;
-    vector<Bullet> bullets;
+    SDL_Window* window = nullptr;
+    SDL_Renderer* renderer = nullptr;
+    TTF_Font* font = nullptr;
+    TextAtlas textAtlas;
+    SpriteBatch batch;
+    AssetLoader loader;
+    ScoreStore scores;
+    ReplayWriter recorder;
+    bool assetsLoaded = false;
+    Uint64 initCounter = 0;
+    bool firstFramePresented = false;
+    // Loader handles; -1 until init() gets as far as queueing the assets.
+    int titlebgImage = -1, startButtonImage = -1, quitButtonImage = -1, backgroundImage = -1, gameoverImage = -1;
+    int musicJob = -1, hitSoundJob = -1, pickupSoundJob = -1;
+    vector<pair<string, int>> spriteJobs;
+    Mix_Music* backgroundMusic = nullptr;
+    Mix_Chunk* hitSound = nullptr;
+    Mix_Chunk* pickupSound = nullptr;
+    SDL_Texture* titlebgTexture = nullptr;
+    SDL_Texture* startButtonTexture = nullptr;
+    SDL_Texture* quitButtonTexture = nullptr;
+    SDL_Texture* backgroundTexture = nullptr;
+    SDL_Texture* gameoverTexture = nullptr;
+    SDL_Texture* menuScene = nullptr;
+    GameState menuSceneState = PLAYING;
+    bool menuSceneDirty = true;
+    bool windowDirty = true;
+    SpriteAtlas spriteAtlas;
+    SDL_Rect bulletSprite;
+    SDL_Rect playerSprite;
+    SDL_Rect enemySprite;
+    SDL_Rect coinSprite;
+    SDL_Rect powerUpSprite;
+    SDL_Rect pistolSprite;
+    SDL_Rect shotgunSprite;
+    SDL_Rect shopHealthSprite;
+    SDL_Rect shopDamageSprite;
+    SDL_Rect upgradeSpeedSprite;
+    SDL_Rect upgradeDamageSprite;
+    SDL_Rect upgradeHealthSprite;
+    GameConfig config;
+    JobSystem jobs;
+    Simulation sim;
+    SimulationRunner runner;
+    const Snapshot* view = nullptr;  // this frame's snapshot
+    uint64_t hitsPlayed = 0, pickupsPlayed = 0, runsRecorded = 0;
+    Animation playerAnimation;
+    SimInput input;
     bool running;
-    int wave;
-    int playerSpeed;
-    int playerHealth;
-    int playerDamage;
-    int score;
-    int coins;
-    Uint32 lastFireTime;
-    const Uint32 fireCooldown = 300;
-
-    SDL_Point randomSafeSpawn() {
-        SDL_Point point;
-        do {
-            point.x = rand() % (SCREEN_WIDTH - 40);
-            point.y = rand() % (SCREEN_HEIGHT - 40);
-        } while (sqrt(pow(player.rect.x - point.x, 2) + pow(player.rect.y - point.y, 2)) < SPAWN_SAFE_RADIUS);
-        return point;
-    }
+    bool showDebug = false;
+    bool showProfiler = false;
+    int traceWrites = 0;
 
     void setupPlayer() {
-        player.frameWidth = PLAYER_SPRITE_WIDTH;
-        player.frameHeight = PLAYER_SPRITE_HEIGHT;
-        player.maxFrames = 4; // If the sprite sheet has 4 frames
+        playerAnimation.frameWidth = PLAYER_SPRITE_WIDTH;
+        playerAnimation.frameHeight = PLAYER_SPRITE_HEIGHT;
+        playerAnimation.maxFrames = 4; // If the sprite sheet has 4 frames
     }
 
-    void updateAnimation(Entity& entity) {
+    void updateAnimation(Animation& animation) {
         Uint32 currentTime = SDL_GetTicks();
-        if (currentTime > entity.lastFrameTime + entity.animationSpeed) {
-            entity.currentFrame = (entity.currentFrame + 1) % entity.maxFrames;
-            entity.lastFrameTime = currentTime;
+        if (currentTime > animation.lastFrameTime + animation.animationSpeed) {
+            animation.currentFrame = (animation.currentFrame + 1) % animation.maxFrames;
+            animation.lastFrameTime = currentTime;
         }
     }
-    
-    void renderEntity(SDL_Texture* texture, SDL_Rect& rect) {
-        SDL_RenderCopy(renderer, texture, NULL, &rect);
+
+    const SDL_Rect& spriteRect(SpriteId id) const {
+        switch (id) {
+            case SPRITE_COIN: return coinSprite;
+            case SPRITE_ENEMY: return enemySprite;
+            case SPRITE_BULLET: return bulletSprite;
+            case SPRITE_POWERUP: return powerUpSprite;
+            default: return playerSprite;
+        }
     }
 
-    void renderEntity(SDL_Texture* texture, Entity& entity) {
-        SDL_Rect srcRect = { entity.currentFrame * entity.frameWidth, 0, entity.frameWidth, entity.frameHeight };
-        SDL_RenderCopy(renderer, texture, &srcRect, &entity.rect);
+    void renderEntity(const SDL_Rect& sprite, const Rect& rect) {
+        batch.draw(spriteAtlas.getTexture(), &sprite, toSDL(rect));
+    }
+
+    void renderEntity(const SDL_Rect& sprite, const Animation& animation, const Rect& rect) {
+        SDL_Rect srcRect = { sprite.x + animation.currentFrame * animation.frameWidth, sprite.y, animation.frameWidth, animation.frameHeight };
+        batch.draw(spriteAtlas.getTexture(), &srcRect, toSDL(rect));
     }
 
     void handleEvents() {
+        PROFILE_ZONE("handleEvents");
         SDL_Event e;
         while (SDL_PollEvent(&e)) {
             if (e.type == SDL_QUIT) running = false;
+            // Anything that may change what a menu shows recomposes it.
+            if (e.type == SDL_KEYDOWN || e.type == SDL_MOUSEBUTTONDOWN ||
+                e.type == SDL_RENDER_TARGETS_RESET || e.type == SDL_RENDER_DEVICE_RESET) menuSceneDirty = true;
+            if (e.type == SDL_WINDOWEVENT) windowDirty = true;
+            if (e.type == SDL_MOUSEBUTTONDOWN) onMouseDown(e.button.x, e.button.y);
+            if (e.type == SDL_KEYDOWN) onKeyDown(e.key.keysym.sym);
+        }
 
-            if (gameState == TITLE_SCREEN && e.type == SDL_MOUSEBUTTONDOWN) {
-                int mouseX = e.button.x;
-                int mouseY = e.button.y;
-    
-                SDL_Rect playButton = {SCREEN_WIDTH / 3 + 50, 400, 200, 100};
-                SDL_Rect quitButton = {SCREEN_WIDTH / 3 + 50, 500, 200, 100};
-    
-                if (mouseX >= playButton.x && mouseX <= playButton.x + playButton.w &&
-                    mouseY >= playButton.y && mouseY <= playButton.y + playButton.h) {
-                    gameState = WEAPON_SELECTION;
-                }
-    
-                if (mouseX >= quitButton.x && mouseX <= quitButton.x + quitButton.w &&
-                    mouseY >= quitButton.y && mouseY <= quitButton.y + quitButton.h) {
-                    running = false;
-                }
-            }
+        const Uint8* keystates = SDL_GetKeyboardState(NULL);
+        input.up = keystates[SDL_SCANCODE_W];
+        input.down = keystates[SDL_SCANCODE_S];
+        input.left = keystates[SDL_SCANCODE_A];
+        input.right = keystates[SDL_SCANCODE_D];
+        int mouseX, mouseY;
+        Uint32 buttons = SDL_GetMouseState(&mouseX, &mouseY);
+        input.aimX = mouseX;
+        input.aimY = mouseY;
+        input.fire = buttons & SDL_BUTTON(SDL_BUTTON_LEFT);
+        runner.setInput(input);
+    }
 
-            if (gameState == GAME_OVER && e.type == SDL_KEYDOWN) {
-                if (e.key.keysym.sym == SDLK_RETURN) {
-                    resetGame();
-                    gameState = TITLE_SCREEN;
-                }
-            }
+    void onMouseDown(int mouseX, int mouseY) {
+        if (view->gameState != TITLE_SCREEN) return;
 
-            
-            if (gameState == WEAPON_SELECTION && e.type == SDL_KEYDOWN) {
-                if (e.key.keysym.sym == SDLK_1) {
-                    selectedWeapon = PISTOL;
-                    gameState = PLAYING;
-                }
-                else if (e.key.keysym.sym == SDLK_2) {
-                    selectedWeapon = SHOTGUN;
-                    gameState = PLAYING;
-                }
-            }
+        SDL_Rect playButton = {SCREEN_WIDTH / 3 + 50, 400, 200, 100};
+        SDL_Rect quitButton = {SCREEN_WIDTH / 3 + 50, 500, 200, 100};
 
-            if (gameState == SHOP || gameState == UPGRADE_MENU) {
-                if (e.type == SDL_KEYDOWN) {
-                    if (gameState == SHOP) {
-                        if (e.key.keysym.sym == SDLK_1 && coins >= 20) {
-                            coins -= 20;
-                            playerHealth += HEALTH_PACK_AMOUNT;
-                        } else if(e.key.keysym.sym == SDLK_2 && coins >= 25){
-                            coins -= 25;
-                            playerDamage += DAMAGE_UPGRADE_AMOUNT;
-                        } else if (e.key.keysym.sym == SDLK_RETURN) {
-                            gameState = PLAYING;
-                        }
-
-                    } else if (gameState == UPGRADE_MENU) {
-                        if (e.key.keysym.sym == SDLK_1) {
-                            playerSpeed += SPEED_UPGRADE_AMOUNT;
-                            gameState = PLAYING;
-                        } else if (e.key.keysym.sym == SDLK_2) {
-                            playerDamage += DAMAGE_UPGRADE_AMOUNT;
-                            gameState = PLAYING;
-                        } else if (e.key.keysym.sym == SDLK_3) {
-                            playerHealth += HEALTH_PACK_AMOUNT;
-                            gameState = PLAYING;
-                        }
-                    }
-                }
-            }
+        if (mouseX >= playButton.x && mouseX <= playButton.x + playButton.w &&
+            mouseY >= playButton.y && mouseY <= playButton.y + playButton.h) {
+            command(CMD_START_GAME);
+        }
+
+        if (mouseX >= quitButton.x && mouseX <= quitButton.x + quitButton.w &&
+            mouseY >= quitButton.y && mouseY <= quitButton.y + quitButton.h) {
+            running = false;
         }
     }
 
-    void shootBullet() {
-        int mouseX, mouseY;
-        SDL_GetMouseState(&mouseX, &mouseY);
-        
-        switch (selectedWeapon) {
-            case PISTOL: {
-                Bullet bullet;
-                bullet.rect = {player.rect.x + player.rect.w / 2 - 5, player.rect.y + player.rect.h / 2 - 5, 10, 10};
-                bullet.dx = (mouseX - bullet.rect.x) / sqrt(pow(mouseX - bullet.rect.x, 2) + pow(mouseY - bullet.rect.y, 2));
-                bullet.dy = (mouseY - bullet.rect.y) / sqrt(pow(mouseX - bullet.rect.x, 2) + pow(mouseY - bullet.rect.y, 2));
-                bullet.speed = 8.0f;
-                bullets.push_back(bullet);
+    void onKeyDown(SDL_Keycode key) {
+        if (key == SDLK_F3) showDebug = !showDebug;
+        if (key == SDLK_F4) showProfiler = !showProfiler;
+        if (key == SDLK_F5) {
+            if (profiler().isTracing()) profiler().writeTrace(nextTracePath());
+            else profiler().startTrace();
+        }
+
+        switch (view->gameState) {
+            case TITLE_SCREEN:
+                if (key == SDLK_h) command(CMD_START_HORDE);
                 break;
-            }
-            case SHOTGUN: {
-                for (int i = - SHOTGUN_BULLET_COUNT / 2; i <= SHOTGUN_BULLET_COUNT / 2; i++) {
-                    Bullet bullet;
-                    bullet.rect = {player.rect.x + player.rect.w / 2 - 5, player.rect.y + player.rect.h / 2 - 5, 10, 10};
-                    double angle = atan2(mouseY - bullet.rect.y, mouseX - bullet.rect.x);
-                    angle += i * SHOTGUN_SPREAD_ANGLE / 100.0;
-                    bullet.dx = cos(angle);
-                    bullet.dy = sin(angle);
-                    bullet.speed = 7.0f;
-                    bullets.push_back(bullet);
-                }
+            case PLAYING:
+                if (key == SDLK_ESCAPE) command(CMD_ABANDON_RUN);
+                break;
+            case GAME_OVER:
+                if (key == SDLK_RETURN) command(CMD_RETURN_TO_TITLE);
+                break;
+            case WEAPON_SELECTION:
+                if (key == SDLK_1) command(CMD_SELECT_PISTOL);
+                else if (key == SDLK_2) command(CMD_SELECT_SHOTGUN);
+                break;
+            case SHOP:
+                if (key == SDLK_1) command(CMD_BUY_HEALTH);
+                else if (key == SDLK_2) command(CMD_BUY_DAMAGE);
+                else if (key == SDLK_RETURN) command(CMD_LEAVE_SHOP);
+                break;
+            case UPGRADE_MENU:
+                if (key == SDLK_1) command(CMD_UPGRADE_SPEED);
+                else if (key == SDLK_2) command(CMD_UPGRADE_DAMAGE);
+                else if (key == SDLK_3) command(CMD_UPGRADE_HEALTH);
+                break;
+            default:
                 break;
-            }
         }
-        lastFireTime = SDL_GetTicks();
-    }
-
-    void spawnWave() {
-        enemies.clear();
-        for (int i = 0; i < wave * 5; i++) {
-            Enemy e;
-            SDL_Point spawn = randomSafeSpawn();
-            e.rect = {spawn.x, spawn.y, 30, 30};
-
-            int enemyTypeRand = rand() % 3;
-            e.type = static_cast<Enemy::EnemyType>(enemyTypeRand);
-            if (e.type == Enemy::BASIC) {
-                e.health = ENEMY_BASIC.health + wave * 2;
-                e.speed = ENEMY_BASIC.speed + wave / 5;
-                e.rect.w = ENEMY_BASIC.size; e.rect.h = ENEMY_BASIC.size;
-            } else if (e.type == Enemy::FAST) {
-                e.speed = ENEMY_FAST.speed + wave / 3;
-                e.health = ENEMY_FAST.health + wave;
-                e.rect.w = ENEMY_FAST.size; e.rect.h = ENEMY_FAST.size;
-            } else if (e.type == Enemy::TANK) {
-                e.speed = ENEMY_TANK.speed + wave / 10;
-                e.health = ENEMY_TANK.health + wave * 5;
-                e.rect.w = ENEMY_TANK.size; e.rect.h = ENEMY_TANK.size;
+    }
+
+    // Draws the current menu screen into menuScene when it is out of date and
+    // only presents when the scene or the window was invalidated.
+    void renderMenu() {
+        PROFILE_ZONE("renderMenu");
+        if (view->gameState != menuSceneState) menuSceneDirty = true;
+        if (!menuSceneDirty && !windowDirty) return;
+
+        if (!menuScene) {
+            drawMenu();
+        } else {
+            if (menuSceneDirty) {
+                batch.flush();
+                SDL_SetRenderTarget(renderer, menuScene);
+                drawMenu();
+                batch.flush();
+                SDL_SetRenderTarget(renderer, NULL);
             }
-            enemies.push_back(e);
+            renderImage(menuScene, 0, 0, SCREEN_WIDTH, SCREEN_HEIGHT);
         }
-        if (rand() % 5 == 0) {
-            PowerUp p;
-            SDL_Point spawn = randomSafeSpawn();
-            p.rect = {spawn.x, spawn.y, 20, 20};
-            p.type = (rand() % 2 == 0) ? PowerUp::HEALTH : PowerUp::SPEED;
-            p.speed = 0;
-            powerUps.push_back(p);
+        menuSceneState = view->gameState;
+        menuSceneDirty = false;
+        windowDirty = false;
+        present();
+    }
+
+    void drawMenu() {
+        switch (view->gameState) {
+            case TITLE_SCREEN: renderTitleScreen(); break;
+            case WEAPON_SELECTION: renderWeaponSelection(); break;
+            case SHOP: renderShop(); break;
+            case UPGRADE_MENU: renderUpgradeMenu(); break;
+            case GAME_OVER: renderGameOver(); break;
+            default: break;
         }
     }
 
-    void resetGame() {
-        playerHealth = 100;
-        score = -200;
-        wave = 1;
-        enemies.clear();
-        bullets.clear();
-        coinsOnGround.clear();
-        powerUps.clear();
+    // Everything that reaches the Simulation goes through the runner, which
+    // records it, so a recording holds all it needs to replay the session.
+    void command(SimCommand cmd) {
+        runner.command(cmd);
     }
 
     void renderTitleScreen() {
-        SDL_SetRenderDrawColor(renderer, 0, 0, 0, 255);
-        SDL_RenderClear(renderer);
+        clearScreen(0, 0, 0);
 
         renderImage(titlebgTexture, 0, 0, SCREEN_WIDTH, SCREEN_HEIGHT);
-        
-        SDL_Rect playButton = {SCREEN_WIDTH / 3 + 50, 400, 200, 100};
-        SDL_Rect quitButton = {SCREEN_WIDTH / 3 + 50, 500, 200, 100};
-        
         renderImage(startButtonTexture, SCREEN_WIDTH / 3 + 50, 400, 200, 100);
         renderImage(quitButtonTexture, SCREEN_WIDTH / 3 + 50, 500, 200, 100);
-    
-        SDL_RenderPresent(renderer);
+        renderText("Press H for horde mode, Esc to end it", SCREEN_WIDTH / 3 - 20, 350);
     }
 
     void renderGameOver() {
-        SDL_SetRenderDrawColor(renderer, 0, 0, 0, 255);
-        SDL_RenderClear(renderer);
-    
-        int highScore = loadHighScore();
+        clearScreen(0, 0, 0);
+
         renderImage(gameoverTexture, 0, 0, SCREEN_WIDTH, SCREEN_HEIGHT);
-        renderText("Your Score: " + to_string(score), SCREEN_WIDTH / 3 + 50, 400);
-        renderText("High Score: " + to_string(highScore), SCREEN_WIDTH / 3 + 50, 450);
+        renderText("Your Score: " + to_string(view->hud.score), SCREEN_WIDTH / 3 + 50, 400);
+        renderText("High Score: " + to_string(scores.highScore()), SCREEN_WIDTH / 3 + 50, 450);
         renderText("Press Enter to return to title", SCREEN_WIDTH / 3, 500);
-    
-        SDL_RenderPresent(renderer);
+
+        // The run that just ended is already recorded, so it shows up here if it ranks.
+        vector<RunRecord> runs = scores.topRuns(GAME_OVER_TOP_RUNS);
+        if (runs.empty()) return;
+        renderText("Best runs:", SCREEN_WIDTH / 3 + 50, 250);
+        for (size_t i = 0; i < runs.size(); i++) {
+            const RunRecord& run = runs[i];
+            string weapon = (run.weapon == SHOTGUN) ? "shotgun" : "pistol";
+            renderText(to_string(i + 1) + ". " + to_string(run.score) + "  wave " + to_string(run.wave) + "  " + weapon,
+                       SCREEN_WIDTH / 3 + 50, 280 + (int)i * 30);
+        }
     }
-    
 
     void renderImage(SDL_Texture* texture, int x, int y, int w, int h) {
         if (!texture) return; // Avoid crashing if texture failed to load
-        SDL_Rect destRect = {x, y, w, h};
-        SDL_RenderCopy(renderer, texture, nullptr, &destRect);
+        SDL_FRect destRect = {(float)x, (float)y, (float)w, (float)h};
+        batch.draw(texture, nullptr, destRect);
     }
 
-    void renderWeaponSelection() {
-        SDL_SetRenderDrawColor(renderer, 50, 50, 50, 255);
+    void renderImage(const SDL_Rect& sprite, int x, int y, int w, int h) {
+        SDL_FRect destRect = {(float)x, (float)y, (float)w, (float)h};
+        batch.draw(spriteAtlas.getTexture(), &sprite, destRect);
+    }
+
+    // Everything is drawn through the batch, so clears and presents flush it first.
+    void clearScreen(Uint8 r, Uint8 g, Uint8 b) {
+        batch.flush();
+        SDL_SetRenderDrawColor(renderer, r, g, b, 255);
         SDL_RenderClear(renderer);
+    }
+
+    void present() {
+        PROFILE_ZONE("present");
+        batch.endFrame();
+        SDL_RenderPresent(renderer);
+        if (!firstFramePresented) {
+            firstFramePresented = true;
+            cout << "Time to first frame: " << millisecondsSince(initCounter) << " ms" << endl;
+        }
+    }
+
+    void renderWeaponSelection() {
+        clearScreen(50, 50, 50);
 
         renderText("Select Your Weapon", SCREEN_WIDTH / 3 - 50, 100);
         renderText("1. Pistol", SCREEN_WIDTH / 3 + 100, 150 + 32);
         renderText("2. Shotgun", SCREEN_WIDTH / 3 + 100, 200 + 32);
-        renderImage(pistolTexture, SCREEN_WIDTH / 3, 150, 64, 64);
-        renderImage(shotgunTexture, SCREEN_WIDTH / 3, 250, 64, 64);
+        renderImage(pistolSprite, SCREEN_WIDTH / 3, 150, 64, 64);
+        renderImage(shotgunSprite, SCREEN_WIDTH / 3, 250, 64, 64);
+    }
 
-        SDL_RenderPresent(renderer);
+    // Shop and upgrade menus sit on top of the game background.
+    void renderMenuBackground() {
+        clearScreen(0, 0, 0);
+        renderImage(backgroundTexture, 0, 0, SCREEN_WIDTH, SCREEN_HEIGHT);
+        renderText("Coins: " + to_string(view->hud.coins), 10, 10);
     }
 
     void renderShop() {
-        SDL_SetRenderDrawColor(renderer, 50, 50, 50, 255);
-        
+        renderMenuBackground();
+
         renderText("1. Health +20 (Cost: 20)", SCREEN_WIDTH / 3 + 100, SCREEN_HEIGHT / 4 + 60 + 32);
         renderText("2. Bullet Damage +2 (Cost: 25)", SCREEN_WIDTH / 3 + 100, SCREEN_HEIGHT / 4 + 140 + 32);
         renderText("Press Enter to Continue", SCREEN_WIDTH / 3 + 100, SCREEN_HEIGHT / 4 + 220);
         renderText("SHOP - Buy Upgrades", SCREEN_WIDTH / 3, SCREEN_HEIGHT / 4 + 20);
-        renderImage(shopHealthTexture, SCREEN_WIDTH / 3, SCREEN_HEIGHT / 4 + 60, 64, 64);
-        renderImage(shopDamageTexture, SCREEN_WIDTH / 3, SCREEN_HEIGHT / 4 + 140, 64, 64);
-
-    SDL_RenderPresent(renderer);
+        renderImage(shopHealthSprite, SCREEN_WIDTH / 3, SCREEN_HEIGHT / 4 + 60, 64, 64);
+        renderImage(shopDamageSprite, SCREEN_WIDTH / 3, SCREEN_HEIGHT / 4 + 140, 64, 64);
     }
 
     void renderUpgradeMenu() {
-        SDL_SetRenderDrawColor(renderer, 50, 50, 50, 255);
+        renderMenuBackground();
 
         renderText("UPGRADE MENU", SCREEN_WIDTH / 3, SCREEN_HEIGHT / 4 + 20);
         renderText("1.Increase Speed", SCREEN_WIDTH / 3 + 100, SCREEN_HEIGHT / 4 + 60 + 32);
         renderText("2.Increase Damage", SCREEN_WIDTH / 3 + 100, SCREEN_HEIGHT / 4 + 140 + 32);
         renderText("3.Increase Max Health", SCREEN_WIDTH / 3 + 100, SCREEN_HEIGHT / 4 + 220 + 32);
-        renderImage(upgradeSpeedTexture, SCREEN_WIDTH / 3, SCREEN_HEIGHT / 4 + 60, 64, 64);
-        renderImage(upgradeDamageTexture, SCREEN_WIDTH / 3, SCREEN_HEIGHT / 4 + 140, 64, 64);
-        renderImage(upgradeHealthTexture, SCREEN_WIDTH / 3, SCREEN_HEIGHT / 4 + 220, 64, 64);
-
-    SDL_RenderPresent(renderer);
-    }
-
-    int loadHighScore() {
-        ifstream file("highscore.txt");
-        int highScore = 0;
-        if (file.is_open()) {
-            file >> highScore;
-            file.close();
-        }
-        return highScore;
-    }
-    
-    void saveHighScore(int score) {
-        int currentHighScore = loadHighScore();
-        if (score > currentHighScore) {
-            ofstream file("highscore.txt");
-            file << score;
-            file.close();
-        }
+        renderImage(upgradeSpeedSprite, SCREEN_WIDTH / 3, SCREEN_HEIGHT / 4 + 60, 64, 64);
+        renderImage(upgradeDamageSprite, SCREEN_WIDTH / 3, SCREEN_HEIGHT / 4 + 140, 64, 64);
+        renderImage(upgradeHealthSprite, SCREEN_WIDTH / 3, SCREEN_HEIGHT / 4 + 220, 64, 64);
     }
 
-    void update() {
-        Uint32 currentTime = SDL_GetTicks();
-
-        if (playerHealth <= 0) {
-            saveHighScore(score);
-            gameState = GAME_OVER;
-        }
-        if (gameState == WEAPON_SELECTION) return;
-        if (gameState == SHOP) return;
-        if (gameState == UPGRADE_MENU) return;
-
-        const Uint8* keystates = SDL_GetKeyboardState(NULL);
-        if (keystates[SDL_SCANCODE_W]) player.rect.y -= player.speed;
-        if (keystates[SDL_SCANCODE_S]) player.rect.y += player.speed;
-        if (keystates[SDL_SCANCODE_A]) player.rect.x -= player.speed;
-        if (keystates[SDL_SCANCODE_D]) player.rect.x += player.speed;
-
-        Wall::keepInside(player.rect);
-        for (auto& e : enemies) {
-            int dx = player.rect.x - e.rect.x;
-            int dy = player.rect.y - e.rect.y;
-            double dist = sqrt((double)(dx * dx + dy * dy));
-            e.rect.x += int(e.speed * dx / dist);
-            e.rect.y += int(e.speed * dy / dist);
-
-            if (SDL_HasIntersection(&player.rect, &e.rect)) {
-                playerHealth -= (e.type == Enemy::TANK) ? 3 : 1;
-                Mix_PlayChannel(-1, hitSound, 0);
-            }
-        }
-
-        if (currentTime - lastFireTime > fireCooldown && SDL_GetMouseState(NULL, NULL) & SDL_BUTTON(SDL_BUTTON_LEFT)) {
-            shootBullet();
-        }
-
-        for (auto& b : bullets) {
-            b.rect.x += int(b.dx * b.speed);
-            b.rect.y += int(b.dy * b.speed);
-        }
-
-        bullets.erase(remove_if(bullets.begin(), bullets.end(), [](Bullet& b) {
-            return b.rect.x < -10 || b.rect.x > SCREEN_WIDTH || b.rect.y < -10 || b.rect.y > SCREEN_HEIGHT;
-        }), bullets.end());
-
-        for (auto bIt = bullets.begin(); bIt != bullets.end();) {
-            bool hit = false;
-            for (auto eIt = enemies.begin(); eIt != enemies.end();) {
-                if (SDL_HasIntersection(&bIt->rect, &eIt->rect)) {
-                    eIt->health -= playerDamage;
-                    if (eIt->health <= 0) {
-                        Coin c;
-                        score += 10;
-                        c.rect = {eIt->rect.x + eIt->rect.w / 2, eIt->rect.y + eIt->rect.h / 2, 15, 15};
-                        coinsOnGround.push_back(c);
-        
-                        eIt = enemies.erase(eIt);
-                    } else {
-                        ++eIt;
-                    }
-                    hit = true;
-                    break;
-                } else {
-                    ++eIt;
-                }
-            }
-        
-            if (hit) {
-                bIt = bullets.erase(bIt);
-            } else {
-                ++bIt;
-            }
-        }
-
-        for (size_t i = 0; i < powerUps.size();) {
-            if (SDL_HasIntersection(&player.rect, &powerUps[i].rect)) {
-                Mix_PlayChannel(-1, pickupSound, 0);
-                if (powerUps[i].type == PowerUp::HEALTH) playerHealth += 20;
-                else if (powerUps[i].type == PowerUp::SPEED) player.speed += 2;
-                powerUps.erase(powerUps.begin() + i);
-            } else i++;
-        }
-
-        for (size_t i = 0; i < coinsOnGround.size();) {
-            if (SDL_HasIntersection(&player.rect, &coinsOnGround[i].rect)) {
-                coins += COIN_VALUE;
-                coinsOnGround.erase(coinsOnGround.begin() + i);
-            } else {
-                i++;
-            }
-        }
-
-        if (enemies.empty()) {
-            if (wave % 3 == 0) gameState = UPGRADE_MENU;
-            if (wave % 5 == 0) {
-                gameState = SHOP;
-            }
-            spawnWave();
-            wave++;
-            player.speed = playerSpeed;
-            score += 100 * wave;
-            
+    // Catches up with the event totals of the snapshot: sounds and finished
+    // runs. Each sound plays at most once a frame; a horde makes thousands of
+    // contacts per tick.
+    void playEvents() {
+        if (view->runsEnded != runsRecorded) {
+            runsRecorded = view->runsEnded;
+            scores.recordRun(view->lastRun);
         }
+        if (hitsPlayed < view->enemyHits) Mix_PlayChannel(-1, hitSound, 0);
+        if (pickupsPlayed < view->pickups) Mix_PlayChannel(-1, pickupSound, 0);
+        hitsPlayed = view->enemyHits;
+        pickupsPlayed = view->pickups;
     }
 
     void renderText(const string& message, int x, int y) {
-        SDL_Color color = {255, 255, 255};
-        SDL_Surface* surface = TTF_RenderText_Solid(font, message.c_str(), color);
-        SDL_Texture* texture = SDL_CreateTextureFromSurface(renderer, surface);
-        SDL_Rect dst = {x, y, surface->w, surface->h};
-        SDL_RenderCopy(renderer, texture, NULL, &dst);
-        SDL_FreeSurface(surface);
-        SDL_DestroyTexture(texture);
+        PROFILE_ZONE("renderText");
+        SDL_Color color = {255, 255, 255, 255};
+        textAtlas.draw(batch, message, x, y, color);
     }
 
-    void render() {
-        SDL_SetRenderDrawColor(renderer, 0, 0, 0, 255);
-        SDL_RenderClear(renderer);
-
-        SDL_SetRenderDrawColor(renderer, 255, 215, 0, 255);
+    // F5 starts a capture, then writes one file per press: trace.json, trace-2.json, ...
+    string nextTracePath() {
+        string path = config.tracePath.empty() ? "trace.json" : config.tracePath;
+        if (++traceWrites == 1) return path;
+        size_t dot = path.rfind('.');
+        if (dot == string::npos) dot = path.size();
+        return path.substr(0, dot) + "-" + to_string(traceWrites) + path.substr(dot);
+    }
 
-        SDL_Rect bgRect = {0, 0, SCREEN_WIDTH, SCREEN_HEIGHT};
-        SDL_RenderCopy(renderer, backgroundTexture, NULL, &bgRect);
-        
-        renderText("Coins: " + to_string(coins), 10, 10);
-        
-        if (gameState == WEAPON_SELECTION) {
-            renderWeaponSelection();
-            return;
-        }
-        if (gameState == SHOP) {
-            renderShop();
-            return;
-        }
-        if (gameState == UPGRADE_MENU) {
-            renderUpgradeMenu();
-            return;
+    // Rolling per-zone frame times (F4) over the profiler's history.
+    void renderProfiler() {
+        int x = SCREEN_WIDTH - 460, y = 10;
+        renderText("zone  min / avg / p99 ms", x, y);
+        for (const ProfileZoneStats& zone : profiler().stats()) {
+            char line[96];
+            snprintf(line, sizeof(line), "%s  %.2f / %.2f / %.2f", zone.name, zone.minMs, zone.avgMs, zone.p99Ms);
+            renderText(line, x, y += 30);
         }
-        
-        SDL_SetRenderDrawColor(renderer, 0, 0, 0, 255);
-        SDL_RenderClear(renderer);
+        const HudValues& hud = view->hud;
+        renderText("Enemies: " + to_string(hud.enemies) + "  Bullets: " + to_string(hud.bullets), x, y += 40);
+        renderText("Coins: " + to_string(hud.coinsOnGround) + "  Power-ups: " + to_string(hud.powerUps), x, y += 30);
+    }
 
-        SDL_RenderCopy(renderer, backgroundTexture, NULL, &bgRect);
+    // alpha: how far the current frame is between the last two sim ticks, 0..1.
+    void render(float alpha) {
+        PROFILE_ZONE("render");
+        clearScreen(0, 0, 0);
 
-        updateAnimation(player);
-        
-        for (auto& c : coinsOnGround) {
-            renderEntity(coinTexture, c.rect);
-        }
-
-        for (auto& e : enemies) {
-            renderEntity(enemyTexture, e.rect);
-        }
+        renderImage(backgroundTexture, 0, 0, SCREEN_WIDTH, SCREEN_HEIGHT);
 
-        SDL_SetRenderDrawColor(renderer, 255, 255, 0, 255);
-        for (auto& b : bullets) renderEntity(bulletTexture, b.rect);
+        updateAnimation(playerAnimation);
 
-        for (auto& p : powerUps) {
-            renderEntity(powerUpTexture, p.rect);
+        for (const SpriteInstance& sprite : view->sprites) {
+            Rect rect = interpolate(sprite.rect, sprite.prev, alpha);
+            if (sprite.sprite == SPRITE_PLAYER) renderEntity(playerSprite, playerAnimation, rect);
+            else renderEntity(spriteRect(sprite.sprite), rect);
         }
 
-        renderEntity(playerTexture, player);
-
-        renderText("Health: " + to_string(playerHealth), 10, 10);
-        renderText("Wave: " + to_string(wave - 1), 10, 40);
-        renderText("Score: " + to_string(score), 10, 70);
-        renderText("Coins: " + to_string(coins), 10, 100);
-
-        SDL_RenderPresent(renderer);
+        const HudValues& hud = view->hud;
+        renderText("Health: " + to_string(hud.health), 10, 10);
+        renderText("Wave: " + to_string(hud.wave - 1), 10, 40);
+        renderText("Score: " + to_string(hud.score), 10, 70);
+        renderText("Coins: " + to_string(hud.coins), 10, 100);
+        if (showDebug) {
+            renderText("Pair tests: " + to_string(hud.stats.narrowPhaseTests) + " / " + to_string(hud.stats.bruteForceTests), 10, 130);
+            renderText("Draw calls: " + to_string(batch.drawCalls) + "  Quads: " + to_string(batch.quads), 10, 160);
+        }
+        if (showProfiler) renderProfiler();
+        present();
     }
 
 };
@@ -0,0 +1,83 @@
+#ifndef SPRITE_ATLAS_H
+#define SPRITE_ATLAS_H
+
+#include <SDL2/SDL.h>
+#include <vector>
+#include <string>
+#include <map>
+#include <algorithm>
+
+using namespace std;
+
+struct SpriteSource {
+    string name;
+    SDL_Surface* surface;
+};
+
+// Packs decoded sprite images into one texture at load time (shelf packing,
+// tallest first) and keeps a name -> source rect table, so every sprite draws
+// from the same texture. The source surfaces are not freed.
+class SpriteAtlas {
+public:
+    bool build(SDL_Renderer* renderer, const vector<SpriteSource>& sources) {
+        const int atlasWidth = 2048;
+
+        vector<SDL_Surface*> surfaces;
+        for (const SpriteSource& source : sources) {
+            if (!source.surface) return false;
+            surfaces.push_back(source.surface);
+        }
+
+        vector<int> order(sources.size());
+        for (size_t i = 0; i < order.size(); i++) order[i] = (int)i;
+        sort(order.begin(), order.end(), [&](int a, int b) { return surfaces[a]->h > surfaces[b]->h; });
+
+        vector<SDL_Rect> placed(sources.size());
+        int penX = 0, penY = 0, rowHeight = 0;
+        for (int i : order) {
+            SDL_Surface* surface = surfaces[i];
+            if (penX + surface->w > atlasWidth) {
+                penX = 0;
+                penY += rowHeight + 1;
+                rowHeight = 0;
+            }
+            placed[i] = {penX, penY, surface->w, surface->h};
+            penX += surface->w + 1;
+            rowHeight = max(rowHeight, surface->h);
+        }
+
+        SDL_Surface* atlas = SDL_CreateRGBSurfaceWithFormat(0, atlasWidth, penY + rowHeight, 32, SDL_PIXELFORMAT_ARGB8888);
+        if (atlas) {
+            SDL_FillRect(atlas, NULL, SDL_MapRGBA(atlas->format, 0, 0, 0, 0));
+            for (size_t i = 0; i < sources.size(); i++) {
+                SDL_SetSurfaceBlendMode(surfaces[i], SDL_BLENDMODE_NONE);
+                SDL_BlitSurface(surfaces[i], NULL, atlas, &placed[i]);
+                rects[sources[i].name] = placed[i];
+            }
+            texture = SDL_CreateTextureFromSurface(renderer, atlas);
+            SDL_SetTextureBlendMode(texture, SDL_BLENDMODE_BLEND);
+            SDL_FreeSurface(atlas);
+        }
+        return texture != nullptr;
+    }
+
+    // Source rect of a sprite inside the atlas texture; empty if unknown.
+    SDL_Rect get(const string& name) const {
+        auto it = rects.find(name);
+        if (it == rects.end()) return {0, 0, 0, 0};
+        return it->second;
+    }
+
+    SDL_Texture* getTexture() const { return texture; }
+
+    void destroy() {
+        if (texture) SDL_DestroyTexture(texture);
+        texture = nullptr;
+    }
+
+private:
+    SDL_Texture* texture = nullptr;
+    map<string, SDL_Rect> rects;
+};
+
+#endif
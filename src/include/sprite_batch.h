@@ -0,0 +1,79 @@
+#ifndef SPRITE_BATCH_H
+#define SPRITE_BATCH_H
+
+#include <SDL2/SDL.h>
+#include <vector>
+
+using namespace std;
+
+// Collects textured quads into one vertex array and submits them with a single
+// SDL_RenderGeometry call per run of quads sharing a texture. Anything drawn
+// outside the batch (clears, present) must flush() first to keep draw order.
+class SpriteBatch {
+public:
+    int drawCalls = 0;  // last completed frame
+    int quads = 0;
+
+    void setRenderer(SDL_Renderer* r) {
+        renderer = r;
+    }
+
+    // src == nullptr draws the whole texture.
+    void draw(SDL_Texture* texture, const SDL_Rect* src, const SDL_FRect& dst, SDL_Color color = {255, 255, 255, 255}) {
+        if (!texture) return;
+        if (texture != current) {
+            flush();
+            current = texture;
+            int w = 1, h = 1;
+            SDL_QueryTexture(texture, NULL, NULL, &w, &h);
+            textureW = (float)w;
+            textureH = (float)h;
+        }
+
+        float u0 = 0, v0 = 0, u1 = 1, v1 = 1;
+        if (src) {
+            u0 = src->x / textureW;
+            v0 = src->y / textureH;
+            u1 = (src->x + src->w) / textureW;
+            v1 = (src->y + src->h) / textureH;
+        }
+        int base = (int)vertices.size();
+        vertices.push_back({{dst.x, dst.y}, color, {u0, v0}});
+        vertices.push_back({{dst.x + dst.w, dst.y}, color, {u1, v0}});
+        vertices.push_back({{dst.x + dst.w, dst.y + dst.h}, color, {u1, v1}});
+        vertices.push_back({{dst.x, dst.y + dst.h}, color, {u0, v1}});
+        int quad[6] = {base, base + 1, base + 2, base, base + 2, base + 3};
+        indices.insert(indices.end(), quad, quad + 6);
+        frameQuads++;
+    }
+
+    void flush() {
+        if (!indices.empty()) {
+            SDL_RenderGeometry(renderer, current, vertices.data(), (int)vertices.size(), indices.data(), (int)indices.size());
+            frameDrawCalls++;
+        }
+        vertices.clear();
+        indices.clear();
+    }
+
+    // Flushes and publishes this frame's counters.
+    void endFrame() {
+        flush();
+        current = nullptr;
+        drawCalls = frameDrawCalls;
+        quads = frameQuads;
+        frameDrawCalls = 0;
+        frameQuads = 0;
+    }
+
+private:
+    SDL_Renderer* renderer = nullptr;
+    SDL_Texture* current = nullptr;
+    float textureW = 1, textureH = 1;
+    vector<SDL_Vertex> vertices;
+    vector<int> indices;
+    int frameDrawCalls = 0;
+    int frameQuads = 0;
+};
+
+#endif
@@ -0,0 +1,93 @@
+#ifndef TEXT_ATLAS_H
+#define TEXT_ATLAS_H
+
+#include <SDL2/SDL.h>
+#include <SDL2/SDL_ttf.h>
+#include <vector>
+#include <string>
+#include <algorithm>
+#include "sprite_batch.h"
+
+using namespace std;
+
+// Printable ASCII rasterized once into a single texture. draw() turns a string
+// into one quad per glyph in a SpriteBatch, so drawing text allocates no
+// surfaces or textures per frame.
+class TextAtlas {
+public:
+    static const int FIRST_CHAR = 32;
+    static const int LAST_CHAR = 126;
+
+    bool build(SDL_Renderer* renderer, TTF_Font* font) {
+        const int atlasWidth = 512;
+        SDL_Color white = {255, 255, 255, 255};
+
+        vector<SDL_Surface*> surfaces;
+        int penX = 0, penY = 0, rowHeight = 0;
+        for (int ch = FIRST_CHAR; ch <= LAST_CHAR; ch++) {
+            Glyph& g = glyphs[ch - FIRST_CHAR];
+            int minx, maxx, miny, maxy;
+            if (TTF_GlyphMetrics32(font, ch, &minx, &maxx, &miny, &maxy, &g.advance) < 0) g.advance = 0;
+
+            SDL_Surface* surface = TTF_RenderGlyph32_Blended(font, ch, white);
+            surfaces.push_back(surface);
+            if (!surface) {
+                g.src = {0, 0, 0, 0};
+                continue;
+            }
+            if (penX + surface->w > atlasWidth) {
+                penX = 0;
+                penY += rowHeight + 1;
+                rowHeight = 0;
+            }
+            g.src = {penX, penY, surface->w, surface->h};
+            penX += surface->w + 1;
+            rowHeight = max(rowHeight, surface->h);
+        }
+
+        SDL_Surface* atlas = SDL_CreateRGBSurfaceWithFormat(0, atlasWidth, penY + rowHeight, 32, SDL_PIXELFORMAT_ARGB8888);
+        if (atlas) {
+            SDL_FillRect(atlas, NULL, SDL_MapRGBA(atlas->format, 0, 0, 0, 0));
+            for (int i = 0; i < (int)surfaces.size(); i++) {
+                if (!surfaces[i]) continue;
+                SDL_SetSurfaceBlendMode(surfaces[i], SDL_BLENDMODE_NONE);
+                SDL_BlitSurface(surfaces[i], NULL, atlas, &glyphs[i].src);
+            }
+            texture = SDL_CreateTextureFromSurface(renderer, atlas);
+            SDL_SetTextureBlendMode(texture, SDL_BLENDMODE_BLEND);
+            SDL_FreeSurface(atlas);
+        }
+        for (SDL_Surface* surface : surfaces) SDL_FreeSurface(surface);
+        return texture != nullptr;
+    }
+
+    void draw(SpriteBatch& batch, const string& message, float x, float y, SDL_Color color) {
+        float penX = x;
+        for (char c : message) {
+            int ch = (unsigned char)c;
+            if (ch < FIRST_CHAR || ch > LAST_CHAR) ch = '?';
+            const Glyph& g = glyphs[ch - FIRST_CHAR];
+            if (g.src.w > 0) {
+                SDL_FRect dst = {penX, y, (float)g.src.w, (float)g.src.h};
+                batch.draw(texture, &g.src, dst, color);
+            }
+            penX += g.advance;
+        }
+    }
+
+    void destroy() {
+        if (texture) SDL_DestroyTexture(texture);
+        texture = nullptr;
+    }
+
+private:
+    struct Glyph {
+        SDL_Rect src;
+        int advance;
+    };
+
+    Glyph glyphs[LAST_CHAR - FIRST_CHAR + 1] = {};
+    SDL_Texture* texture = nullptr;
+};
+
+#endif